@@ -34,6 +34,7 @@
 #include "cli/cli-utils.h"
 #include "extension.h"
 #include "gdbarch.h"
+#include "gdbsupport/unordered_map.h"
 
 /* For maintenance commands.  */
 #include "record-btrace.h"
@@ -1085,6 +1086,15 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
   unsigned int blk;
   int level;
 
+  /* The size and class of instructions we already decoded.  Branch
+     trace typically covers the same code over and over again (loops,
+     frequently called functions), and both computing the length and
+     classifying an instruction require disassembling it.  Memory does
+     not change while we compute the trace, so the cache is valid for
+     the duration of this call.  */
+  gdb::unordered_map<CORE_ADDR, std::pair<int, enum btrace_insn_class>>
+    insn_cache;
+
   gdbarch *gdbarch = current_inferior ()->arch ();
   btinfo = &tp->btrace;
   blk = btrace->blocks->size ();
@@ -1130,18 +1140,29 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
 	  if (blk != 0)
 	    level = std::min (level, bfun->level);
 
-	  size = 0;
-	  try
+	  auto cached = insn_cache.find (pc);
+	  if (cached != insn_cache.end ())
 	    {
-	      size = gdb_insn_length (gdbarch, pc);
+	      size = cached->second.first;
+	      insn.iclass = cached->second.second;
 	    }
-	  catch (const gdb_exception_error &error)
+	  else
 	    {
+	      size = 0;
+	      try
+		{
+		  size = gdb_insn_length (gdbarch, pc);
+		}
+	      catch (const gdb_exception_error &error)
+		{
+		}
+
+	      insn.iclass = ftrace_classify_insn (gdbarch, pc);
+	      insn_cache.emplace (pc, std::make_pair (size, insn.iclass));
 	    }
 
 	  insn.pc = pc;
 	  insn.size = size;
-	  insn.iclass = ftrace_classify_insn (gdbarch, pc);
 	  insn.flags = 0;
 
 	  ftrace_update_insns (bfun, insn);
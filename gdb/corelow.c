@@ -20,6 +20,7 @@
 #include "arch-utils.h"
 #include <signal.h>
 #include <fcntl.h>
+#include "event-top.h"
 #include "exceptions.h"
 #include "frame.h"
 #include "inferior.h"
@@ -45,14 +46,18 @@
 #include "build-id.h"
 #include "gdbsupport/pathstuff.h"
 #include "gdbsupport/scoped_fd.h"
+#include "gdbsupport/scoped_mmap.h"
 #include "gdbsupport/x86-xstate.h"
 #include "gdbsupport/unordered_map.h"
 #include "gdbsupport/unordered_set.h"
 #include "cli/cli-cmds.h"
+#include "cli/cli-option.h"
 #include "xml-tdesc.h"
 #include "memtag.h"
 #include "cli/cli-style.h"
 #include "observable.h"
+#include "top.h"
+#include <chrono>
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -296,6 +301,34 @@ class core_target final : public process_stratum_target
      targets.  */
   std::vector<target_section> m_core_section_table;
 
+#if HAVE_SYS_MMAN_H
+  /* A range of the core's memory whose contents are stored verbatim
+     in the core file, starting at file offset FILEPOS.  */
+  struct mapped_core_range
+  {
+    CORE_ADDR start;
+    CORE_ADDR end;
+    file_ptr filepos;
+  };
+
+  /* A read-only mapping of the whole core file, if it could be
+     mapped.  */
+  std::optional<scoped_mmap> m_core_mapping;
+
+  /* The memory ranges of M_CORE_MAPPING, sorted by address.  Empty if
+     the core file isn't mapped.  */
+  std::vector<mapped_core_range> m_mapped_core_ranges;
+
+  /* Map the core file and fill in m_mapped_core_ranges.  Called from
+     the constructor.  */
+  void map_core_file ();
+
+  /* Read LEN bytes of memory at OFFSET from M_CORE_MAPPING into
+     READBUF.  Return false if OFFSET isn't within a mapped range.  */
+  bool xfer_mapped_memory (gdb_byte *readbuf, ULONGEST offset,
+			   ULONGEST len, ULONGEST *xfered_len);
+#endif
+
   /* File-backed address space mappings: some core files include
      information about memory mapped files.  */
   std::vector<target_section> m_core_file_mappings;
@@ -383,9 +416,108 @@ core_target::core_target (gdb_bfd_ref_ptr cbfd_ref)
   /* Find the data section */
   m_core_section_table = build_section_table (this->core_bfd ());
 
+#if HAVE_SYS_MMAN_H
+  map_core_file ();
+#endif
+
   build_file_mappings ();
 }
 
+#if HAVE_SYS_MMAN_H
+
+/* Memory reads from a core file otherwise go through
+   bfd_get_section_contents, which seeks and copies through the BFD
+   file cache for every access.  For an ELF core, whose load segments
+   are stored uncompressed, read the memory straight from a mapping of
+   the file instead, so that only the pages actually accessed are ever
+   read in.  */
+
+void
+core_target::map_core_file ()
+{
+  bfd *cbfd = this->core_bfd ();
+
+  /* Writes to the core go through BFD, which would leave a private
+     mapping stale.  */
+  if (write_files || bfd_get_flavour (cbfd) != bfd_target_elf_flavour)
+    return;
+
+  try
+    {
+      m_core_mapping.emplace (mmap_file (bfd_get_filename (cbfd)));
+    }
+  catch (const gdb_exception_error &except)
+    {
+      return;
+    }
+
+  ULONGEST file_size = m_core_mapping->size ();
+  for (const target_section &ts : m_core_section_table)
+    {
+      asection *sect = ts.the_bfd_section;
+
+      if ((sect->flags & SEC_HAS_CONTENTS) == 0 || ts.endaddr <= ts.addr)
+	continue;
+
+      if (sect->filepos < 0
+	  || (ULONGEST) sect->filepos > file_size
+	  || ts.endaddr - ts.addr > file_size - sect->filepos)
+	{
+	  /* A truncated core; let BFD report the errors.  */
+	  m_mapped_core_ranges.clear ();
+	  break;
+	}
+
+      m_mapped_core_ranges.push_back ({ ts.addr, ts.endaddr, sect->filepos });
+    }
+
+  std::sort (m_mapped_core_ranges.begin (), m_mapped_core_ranges.end (),
+	     [] (const mapped_core_range &a, const mapped_core_range &b)
+	     {
+	       return a.start < b.start;
+	     });
+
+  /* The section table is searched in order, so with overlapping
+     sections the first one wins.  Don't try to replicate that.  */
+  for (size_t i = 1; i < m_mapped_core_ranges.size (); ++i)
+    if (m_mapped_core_ranges[i].start < m_mapped_core_ranges[i - 1].end)
+      {
+	m_mapped_core_ranges.clear ();
+	break;
+      }
+
+  if (m_mapped_core_ranges.empty ())
+    m_core_mapping.reset ();
+}
+
+/* See class declaration above.  */
+
+bool
+core_target::xfer_mapped_memory (gdb_byte *readbuf, ULONGEST offset,
+				 ULONGEST len, ULONGEST *xfered_len)
+{
+  auto it = std::upper_bound (m_mapped_core_ranges.begin (),
+			      m_mapped_core_ranges.end (), offset,
+			      [] (ULONGEST addr, const mapped_core_range &r)
+			      {
+				return addr < r.start;
+			      });
+  if (it == m_mapped_core_ranges.begin ())
+    return false;
+
+  --it;
+  if (offset >= it->end)
+    return false;
+
+  len = std::min<ULONGEST> (len, it->end - offset);
+  const gdb_byte *base = (const gdb_byte *) m_core_mapping->get ();
+  memcpy (readbuf, base + it->filepos + (offset - it->start), len);
+  *xfered_len = len;
+  return true;
+}
+
+#endif /* HAVE_SYS_MMAN_H */
+
 /* Construct the table for file-backed mappings if they exist.
 
    For each unique path in the note, we'll open a BFD with a bfd
@@ -703,6 +835,128 @@ core_file_command (const char *filename, int from_tty)
     core_target_open (filename, from_tty);
 }
 
+/* The options for the "core-file-batch" command.  */
+
+struct core_file_batch_opts
+{
+  /* For "-command".  */
+  std::string command = "thread apply all bt";
+};
+
+static const gdb::option::option_def core_file_batch_option_defs[] = {
+
+  gdb::option::string_option_def<core_file_batch_opts> {
+    "command",
+    [] (core_file_batch_opts *opts) { return &opts->command; },
+    nullptr,
+    N_("The command to run for each core file.  The default is\n\
+\"thread apply all bt\"."),
+  },
+
+};
+
+/* Create an option_def_group for the "core-file-batch" command's
+   options, with OPTS as context.  */
+
+static inline gdb::option::option_def_group
+make_core_file_batch_options_def_group (core_file_batch_opts *opts)
+{
+  return {{core_file_batch_option_defs}, opts};
+}
+
+/* Implementation of the "core-file-batch" command.  Load each core
+   file in turn, run a command on it, and unload it again.
+
+   The BFDs of all the objfiles loaded along the way are kept open
+   until the command completes.  Opening the same file again for a
+   later core then shares the BFD, and with it the minimal symbols and
+   the DWARF index that were already read for it, so only the first
+   core using a given executable or shared library pays for reading
+   its symbols.  */
+
+static void
+core_file_batch_command (const char *args, int from_tty)
+{
+  dont_repeat ();
+
+  core_file_batch_opts opts;
+  auto grp = make_core_file_batch_options_def_group (&opts);
+  gdb::option::process_options
+    (&args, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_OPERAND, grp);
+
+  /* Split ARGS into file names, keeping any quoting, as
+     core_target_open parses its argument itself.  */
+  std::vector<std::string> core_files;
+  args = skip_spaces (args);
+  while (args != nullptr && *args != '\0')
+    {
+      const char *start = args;
+      extract_string_maybe_quoted (&args);
+      core_files.emplace_back (start, args - start);
+      args = skip_spaces (args);
+    }
+
+  if (core_files.empty ())
+    error (_("No core files specified."));
+
+  /* If the user loaded an executable, use it for every core.
+     Otherwise each core's executable is found from its build-id, and
+     unloaded again along with the core.  */
+  bool keep_exec = (current_program_space->exec_bfd () != nullptr
+		    || current_program_space->symfile_object_file != nullptr);
+
+  std::vector<gdb_bfd_ref_ptr> resident_bfds;
+  gdb::unordered_set<bfd *> seen_bfds;
+
+  int failed = 0;
+  auto start_time = std::chrono::steady_clock::now ();
+
+  for (const std::string &core_file : core_files)
+    {
+      QUIT;
+
+      gdb_printf (_("Core file: %ps\n"),
+		  styled_string (file_name_style.style (),
+				 core_file.c_str ()));
+      try
+	{
+	  core_target_open (core_file.c_str (), 0);
+	  execute_command (opts.command.c_str (), 0);
+	}
+      catch (const gdb_exception_error &except)
+	{
+	  exception_print (gdb_stderr, except);
+	  ++failed;
+	}
+
+      for (objfile &objf : current_program_space->objfiles ())
+	if (seen_bfds.insert (objf.obfd.get ()).second)
+	  resident_bfds.push_back
+	    (gdb_bfd_ref_ptr::new_reference (objf.obfd.get ()));
+
+      if (get_core_target (current_inferior ()) != nullptr)
+	target_detach (current_inferior (), 0);
+
+      if (!keep_exec)
+	{
+	  symbol_file_clear (0);
+	  exec_file_attach (nullptr, 0);
+	}
+
+      gdb_printf ("\n");
+      gdb_flush (gdb_stdout);
+    }
+
+  std::chrono::duration<double> elapsed
+    = std::chrono::steady_clock::now () - start_time;
+  double seconds = elapsed.count ();
+  gdb_printf (_("Processed %zu core files (%d failed) in %.2f seconds"),
+	      core_files.size (), failed, seconds);
+  if (seconds > 0)
+    gdb_printf (_(", %.1f cores/minute"), core_files.size () * 60 / seconds);
+  gdb_printf (_(".\n"));
+}
+
 /* A vmcore file is a core file created by the Linux kernel at the point of
    a crash.  Each thread in the core file represents a real CPU core, and
    the lwpid for each thread is the pid of the process that was running on
@@ -1409,6 +1663,12 @@ core_target::xfer_partial (enum target_object object, const char *annex,
       {
 	enum target_xfer_status xfer_status;
 
+#if HAVE_SYS_MMAN_H
+	if (readbuf != nullptr
+	    && xfer_mapped_memory (readbuf, offset, len, xfered_len))
+	  return TARGET_XFER_OK;
+#endif
+
 	/* Try accessing memory contents from core file data,
 	   restricting consideration to those sections for which
 	   the BFD section flag SEC_HAS_CONTENTS is set.  */
@@ -2213,4 +2473,25 @@ INIT_GDB_FILE (corelow)
 	   maintenance_print_core_file_backed_mappings,
 	   _("Print core file's file-backed mappings."),
 	   &maintenanceprintlist);
+
+  auto grp = make_core_file_batch_options_def_group (nullptr);
+  static std::string core_file_batch_help
+    = gdb::option::build_help (_("\
+Load core files one after another, running a command on each.\n\
+Usage: core-file-batch [OPTION]... CORE-FILE...\n\
+\n\
+Options:\n\
+%OPTIONS%\n\
+\n\
+Each core file is loaded, the command is run, and the core file is\n\
+unloaded again before moving on to the next one.  Unless an executable\n\
+is already loaded, each core's executable is found from the core file.\n\
+Object files read for one core file stay open until the command\n\
+completes, so later core files using them load faster.\n\
+Finally, the number of core files processed per minute is shown."),
+			       grp);
+  cmd_list_element *c = add_cmd ("core-file-batch", class_files,
+				 core_file_batch_command,
+				 core_file_batch_help.c_str (), &cmdlist);
+  set_cmd_completer (c, deprecated_filename_completer);
 }
@@ -0,0 +1,511 @@
+/* Built-in printers for libstdc++ containers.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "cp-builtin-printers.h"
+#include "cli/cli-cmds.h"
+#include "command.h"
+#include "gdbtypes.h"
+#include "symtab.h"
+#include "valprint.h"
+#include "value.h"
+
+/* The libstdc++ Python pretty-printers are the usual way to print
+   standard containers, but printing a large container with them calls
+   into Python for every element, and reads every element from memory
+   separately.  The printers in this file handle the most common
+   containers directly, reading contiguous element storage in large
+   blocks, and print them exactly like the Python printers do.  They
+   are used instead of the extension language printers when enabled
+   with "set print builtin-libstdcxx".  */
+
+/* Whether the built-in printers are used, for "set/show print
+   builtin-libstdcxx".  */
+
+static bool builtin_libstdcxx_printers = false;
+
+/* The number of bytes of elements that are read from memory at
+   once.  */
+
+#define BUILTIN_PRINTER_BATCH_BYTES (64 * 1024)
+
+/* Return the member NAME of the structure VAL.  Throw an error if
+   there is no such member.  */
+
+static struct value *
+member (struct value *val, const char *name)
+{
+  return value_struct_elt (&val, {}, name, nullptr, "structure");
+}
+
+/* Return the address held by the pointer member NAME of VAL.  */
+
+static CORE_ADDR
+member_address (struct value *val, const char *name)
+{
+  return value_as_address (member (val, name));
+}
+
+/* Return "1 element" or "N elements", as the Python printers do.  */
+
+static std::string
+num_elements (ULONGEST n)
+{
+  if (n == 1)
+    return "1 element";
+  return string_printf ("%s elements", pulongest (n));
+}
+
+/* Reads the elements of an array in memory, a batch at a time.  */
+
+class array_reader
+{
+public:
+
+  array_reader (struct type *elt_type, CORE_ADDR addr, ULONGEST count)
+    : m_elt_type (elt_type),
+      m_elt_len (check_typedef (elt_type)->length ()),
+      m_addr (addr),
+      m_count (count)
+  {
+    m_batch_size = std::max<ULONGEST> (BUILTIN_PRINTER_BATCH_BYTES
+				       / std::max<ULONGEST> (m_elt_len, 1), 1);
+  }
+
+  /* Return element N of the array, reading the batch of elements that
+     holds it if needed.  */
+
+  struct value *element (ULONGEST n)
+  {
+    gdb_assert (n < m_count);
+
+    if (m_batch == nullptr
+	|| n < m_batch_start || n >= m_batch_start + m_batch_size)
+      {
+	ULONGEST length = std::min (m_batch_size, m_count - n);
+	struct type *array_type
+	  = lookup_array_range_type (m_elt_type, 0, length - 1);
+
+	m_batch = nullptr;
+	try
+	  {
+	    m_batch = release_value (value_at (array_type,
+					       m_addr + n * m_elt_len));
+	    m_batch_start = n;
+	  }
+	catch (const gdb_exception_error &except)
+	  {
+	    /* Let the element itself show the error when it is
+	       printed.  */
+	    return value_at_lazy (m_elt_type, m_addr + n * m_elt_len);
+	  }
+      }
+
+    return value_subscript (m_batch.get (), n - m_batch_start);
+  }
+
+private:
+
+  /* The type and size of the elements.  */
+  struct type *m_elt_type;
+  ULONGEST m_elt_len;
+
+  /* The address and number of elements of the array.  */
+  CORE_ADDR m_addr;
+  ULONGEST m_count;
+
+  /* The number of elements read from memory at once.  */
+  ULONGEST m_batch_size;
+
+  /* The elements read last, starting at element M_BATCH_START, or
+     NULL.  */
+  value_ref_ptr m_batch;
+  ULONGEST m_batch_start = 0;
+};
+
+/* Describe the std::__cxx11::basic_string VAL in RESULT.  Return false
+   if VAL does not have the expected layout.  */
+
+static bool
+describe_std_string (builtin_libstdcxx_container &result, struct value *val)
+{
+  struct value *ptr = member (member (val, "_M_dataplus"), "_M_p");
+  struct type *ptr_type = check_typedef (ptr->type ());
+  if (ptr_type->code () != TYPE_CODE_PTR)
+    return false;
+
+  result.hint = "string";
+  result.string_addr = value_as_address (ptr);
+  result.string_length = value_as_long (member (val, "_M_string_length"));
+  result.char_type = ptr_type->target_type ();
+  result.child = [] (ULONGEST n) -> struct value *
+    {
+      return nullptr;
+    };
+  return true;
+}
+
+/* Describe the std::vector VAL in RESULT, except for std::vector<bool>.
+   Return false if VAL does not have the expected layout.  */
+
+static bool
+describe_std_vector (builtin_libstdcxx_container &result, struct value *val)
+{
+  struct value *impl = member (val, "_M_impl");
+  struct value *start = member (impl, "_M_start");
+
+  /* The storage of std::vector<bool> is accessed through iterators.  */
+  struct type *ptr_type = check_typedef (start->type ());
+  if (ptr_type->code () != TYPE_CODE_PTR)
+    return false;
+
+  struct type *elt_type = ptr_type->target_type ();
+  ULONGEST elt_len = check_typedef (elt_type)->length ();
+  CORE_ADDR first = value_as_address (start);
+  CORE_ADDR finish = member_address (impl, "_M_finish");
+  CORE_ADDR end = member_address (impl, "_M_end_of_storage");
+  if (elt_len == 0 || finish < first || end < finish)
+    return false;
+
+  ULONGEST length = (finish - first) / elt_len;
+  ULONGEST capacity = (end - first) / elt_len;
+
+  result.hint = "array";
+  result.summary = string_printf ("std::vector of length %s, capacity %s",
+				  pulongest (length), pulongest (capacity));
+
+  array_reader elements (elt_type, first, length);
+  result.child = [=] (ULONGEST n) mutable -> struct value *
+    {
+      if (n >= length)
+	return nullptr;
+      return elements.element (n);
+    };
+  return true;
+}
+
+/* Describe the std::deque VAL in RESULT.  Return false if VAL does not
+   have the expected layout.  */
+
+static bool
+describe_std_deque (builtin_libstdcxx_container &result, struct value *val)
+{
+  struct value *impl = member (val, "_M_impl");
+  struct value *start = member (impl, "_M_start");
+  struct value *finish = member (impl, "_M_finish");
+
+  struct value *start_node = member (start, "_M_node");
+  struct type *node_type = check_typedef (start_node->type ());
+  struct type *ptr_type = check_typedef (member (start, "_M_cur")->type ());
+  if (node_type->code () != TYPE_CODE_PTR
+      || ptr_type->code () != TYPE_CODE_PTR)
+    return false;
+
+  struct type *elt_type = ptr_type->target_type ();
+  ULONGEST elt_len = check_typedef (elt_type)->length ();
+  ULONGEST ptr_len = ptr_type->length ();
+  if (elt_len == 0)
+    return false;
+
+  /* This is _GLIBCXX_DEQUE_BUF_SIZE, as used by __deque_buf_size.  */
+  ULONGEST buffer_size = elt_len < 512 ? 512 / elt_len : 1;
+
+  CORE_ADDR s_cur = member_address (start, "_M_cur");
+  CORE_ADDR s_first = member_address (start, "_M_first");
+  CORE_ADDR s_last = member_address (start, "_M_last");
+  CORE_ADDR s_node = value_as_address (start_node);
+  CORE_ADDR f_cur = member_address (finish, "_M_cur");
+  CORE_ADDR f_first = member_address (finish, "_M_first");
+  CORE_ADDR f_node = member_address (finish, "_M_node");
+  if (f_node < s_node || s_last < s_cur || f_cur < f_first
+      || (f_node == s_node && f_cur < s_cur))
+    return false;
+
+  ULONGEST length;
+  if (f_node == s_node)
+    length = (f_cur - s_cur) / elt_len;
+  else
+    length = (buffer_size * ((f_node - s_node) / ptr_len - 1)
+	      + (f_cur - f_first) / elt_len
+	      + (s_last - s_cur) / elt_len);
+
+  result.hint = "array";
+  result.summary = "std::deque with " + num_elements (length);
+
+  /* Each node points to a buffer of BUFFER_SIZE elements, which is
+     read as a whole.  */
+  ULONGEST skip = (s_cur - s_first) / elt_len;
+  std::optional<array_reader> buffer;
+  ULONGEST buffer_node = 0;
+  result.child = [=] (ULONGEST n) mutable -> struct value *
+    {
+      if (n >= length)
+	return nullptr;
+
+      ULONGEST index = skip + n;
+      ULONGEST node = index / buffer_size;
+      if (!buffer.has_value () || buffer_node != node)
+	{
+	  struct value *node_val
+	    = value_at (node_type->target_type (), s_node + node * ptr_len);
+	  buffer.emplace (elt_type, value_as_address (node_val),
+			  buffer_size);
+	  buffer_node = node;
+	}
+      return buffer->element (index % buffer_size);
+    };
+  return true;
+}
+
+/* Describe the std::unordered_map VAL in RESULT.  TYPE is the type of
+   VAL, with typedefs stripped.  Return false if VAL does not have the
+   expected layout.  */
+
+static bool
+describe_std_unordered_map (builtin_libstdcxx_container &result,
+			    struct value *val, struct type *type)
+{
+  /* The nodes store a std::pair<const Key, T>, whose layout follows
+     from the template arguments.  */
+  if (TYPE_N_TEMPLATE_ARGUMENTS (type) < 2
+      || TYPE_TEMPLATE_ARGUMENT (type, 0)->loc_class () != LOC_TYPEDEF
+      || TYPE_TEMPLATE_ARGUMENT (type, 1)->loc_class () != LOC_TYPEDEF)
+    return false;
+
+  struct type *key_type = TYPE_TEMPLATE_ARGUMENT (type, 0)->type ();
+  struct type *mapped_type = TYPE_TEMPLATE_ARGUMENT (type, 1)->type ();
+
+  struct value *hashtable = member (val, "_M_h");
+  ULONGEST count = value_as_long (member (hashtable, "_M_element_count"));
+  struct value *first = member (member (hashtable, "_M_before_begin"),
+				"_M_nxt");
+  struct type *next_type = first->type ();
+  if (check_typedef (next_type)->code () != TYPE_CODE_PTR)
+    return false;
+
+  /* A node starts with the pointer to the next node, followed by the
+     value.  */
+  ULONGEST pair_align = std::max (type_align (key_type),
+				  type_align (mapped_type));
+  ULONGEST value_offset = align_up (check_typedef (next_type)->length (),
+				    pair_align);
+  ULONGEST mapped_offset = align_up (check_typedef (key_type)->length (),
+				     type_align (mapped_type));
+
+  result.hint = "map";
+  result.summary = "std::unordered_map with " + num_elements (count);
+
+  /* The list of nodes is followed as children are requested, going
+     back to its start if an earlier child is requested again.  */
+  CORE_ADDR first_node = value_as_address (first);
+  CORE_ADDR node = first_node;
+  ULONGEST node_index = 0;
+  result.child = [=] (ULONGEST n) mutable -> struct value *
+    {
+      if (n / 2 < node_index)
+	{
+	  node = first_node;
+	  node_index = 0;
+	}
+      while (node != 0 && node_index < n / 2)
+	{
+	  node = value_as_address (value_at (next_type, node));
+	  ++node_index;
+	}
+      if (node == 0)
+	return nullptr;
+
+      if (n % 2 == 0)
+	return value_at_lazy (key_type, node + value_offset);
+      return value_at_lazy (mapped_type,
+			    node + value_offset + mapped_offset);
+    };
+  return true;
+}
+
+/* See cp-builtin-printers.h.  */
+
+std::unique_ptr<builtin_libstdcxx_container>
+get_builtin_libstdcxx_container (struct value *val)
+{
+  if (!builtin_libstdcxx_printers)
+    return nullptr;
+
+  struct type *type = check_typedef (val->type ());
+  if (TYPE_IS_REFERENCE (type))
+    {
+      val = coerce_ref (val);
+      type = check_typedef (val->type ());
+    }
+
+  if (type->code () != TYPE_CODE_STRUCT || type->name () == nullptr)
+    return nullptr;
+
+  enum { std_string, std_vector, std_deque, std_unordered_map } kind;
+  if (startswith (type->name (), "std::__cxx11::basic_string<"))
+    kind = std_string;
+  else if (startswith (type->name (), "std::vector<"))
+    kind = std_vector;
+  else if (startswith (type->name (), "std::deque<"))
+    kind = std_deque;
+  else if (startswith (type->name (), "std::unordered_map<"))
+    kind = std_unordered_map;
+  else
+    return nullptr;
+
+  auto result = std::make_unique<builtin_libstdcxx_container> ();
+  result->arch = type->arch ();
+  try
+    {
+      if (val->lazy ())
+	val->fetch_lazy ();
+      if (!val->bytes_available (0, type->length ()))
+	return nullptr;
+
+      bool described = false;
+      switch (kind)
+	{
+	case std_string:
+	  described = describe_std_string (*result, val);
+	  break;
+	case std_vector:
+	  described = describe_std_vector (*result, val);
+	  break;
+	case std_deque:
+	  described = describe_std_deque (*result, val);
+	  break;
+	case std_unordered_map:
+	  described = describe_std_unordered_map (*result, val, type);
+	  break;
+	}
+      if (!described)
+	return nullptr;
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* If the container turns out not to have the expected layout, or
+	 can't be read, let the extension language printers try.  */
+      return nullptr;
+    }
+
+  return result;
+}
+
+/* The children of a container described by
+   get_builtin_libstdcxx_container, for print_pretty_children.  */
+
+class builtin_children : public pretty_children
+{
+public:
+
+  explicit builtin_children (builtin_libstdcxx_container &container)
+    : m_container (container)
+  {}
+
+  pretty_child_status fetch (unsigned int n) override
+  {
+    m_child = m_container.child (n);
+    if (m_child == nullptr)
+      return pretty_child_status::END;
+    m_name = string_printf ("[%u]", n);
+    return pretty_child_status::CHILD;
+  }
+
+  const char *name () override
+  {
+    return m_name.c_str ();
+  }
+
+  void print (struct ui_file *stream, int recurse,
+	      const struct value_print_options *options,
+	      const struct language_defn *language) override
+  {
+    common_val_print (m_child, stream, recurse, options, language);
+  }
+
+private:
+
+  builtin_libstdcxx_container &m_container;
+
+  /* The child fetched last, and its name.  */
+  struct value *m_child = nullptr;
+  std::string m_name;
+};
+
+/* See cp-builtin-printers.h.  */
+
+bool
+apply_builtin_libstdcxx_printer (struct value *val, struct ui_file *stream,
+				 int recurse,
+				 const struct value_print_options *options,
+				 const struct language_defn *language)
+{
+  std::unique_ptr<builtin_libstdcxx_container> container
+    = get_builtin_libstdcxx_container (val);
+  if (container == nullptr)
+    return false;
+
+  /* Once something is printed, errors propagate as for any value.  */
+  if (strcmp (container->hint, "string") == 0)
+    {
+      struct value_print_options opts = *options;
+      opts.addressprint = false;
+      val_print_string (container->char_type, nullptr,
+			container->string_addr, container->string_length,
+			stream, &opts);
+      return true;
+    }
+
+  gdb_puts (container->summary.c_str (), stream);
+
+  builtin_children children (*container);
+  print_pretty_children (children,
+			 (strcmp (container->hint, "map") == 0
+			  ? pretty_children_layout::MAP
+			  : pretty_children_layout::ARRAY),
+			 true, stream, recurse, options, language);
+  return true;
+}
+
+/* "show print builtin-libstdcxx" handler.  */
+
+static void
+show_builtin_libstdcxx_printers (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  gdb_printf (file, _("Printing of libstdc++ containers by GDB's "
+		      "built-in printers is %s.\n"),
+	      value);
+}
+
+INIT_GDB_FILE (cp_builtin_printers)
+{
+  add_setshow_boolean_cmd ("builtin-libstdcxx", class_support,
+			   &builtin_libstdcxx_printers, _("\
+Set printing of libstdc++ containers by GDB's built-in printers."), _("\
+Show printing of libstdc++ containers by GDB's built-in printers."), _("\
+When on, std::string, std::vector, std::deque and std::unordered_map\n\
+values are printed by printers built into GDB, which print them like\n\
+the libstdc++ Python pretty-printers do, but much faster for large\n\
+containers.  These printers take precedence over extension language\n\
+pretty-printers for these types."),
+			   nullptr,
+			   show_builtin_libstdcxx_printers,
+			   &setprintlist, &showprintlist);
+}
@@ -0,0 +1,79 @@
+/* Built-in printers for libstdc++ containers.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDB_CP_BUILTIN_PRINTERS_H
+#define GDB_CP_BUILTIN_PRINTERS_H
+
+#include <functional>
+
+struct value;
+struct ui_file;
+struct value_print_options;
+struct language_defn;
+
+/* A libstdc++ container that GDB's built-in printers know how to
+   print, described the way the libstdc++ Python pretty-printer of the
+   container presents it.  */
+
+struct builtin_libstdcxx_container
+{
+  /* The display hint of the Python printer: "string", "array" or
+     "map".  */
+  const char *hint = nullptr;
+
+  /* The architecture of the container.  */
+  struct gdbarch *arch = nullptr;
+
+  /* For a string, its STRING_LENGTH characters of type CHAR_TYPE, at
+     STRING_ADDR.  */
+  CORE_ADDR string_addr = 0;
+  LONGEST string_length = 0;
+  struct type *char_type = nullptr;
+
+  /* Otherwise, the text printed before the children, as returned by
+     the to_string method of the Python printer.  */
+  std::string summary;
+
+  /* Return child N of the container, or NULL if there are no more
+     children.  The children of a map alternate between keys and
+     values.  Children are read most efficiently when they are requested
+     in order.  */
+  std::function<struct value * (ULONGEST n)> child;
+};
+
+/* If "set print builtin-libstdcxx" is on and VAL is one of the
+   libstdc++ containers GDB knows how to print itself, return its
+   description.  Otherwise, or if VAL can't be read or does not have
+   the expected layout, return NULL.  */
+
+extern std::unique_ptr<builtin_libstdcxx_container>
+  get_builtin_libstdcxx_container (struct value *val);
+
+/* If "set print builtin-libstdcxx" is on and VAL is one of the
+   libstdc++ containers GDB knows how to print itself, print VAL to
+   STREAM the way the libstdc++ Python pretty-printers do, and return
+   true.  Otherwise, print nothing and return false.  RECURSE, OPTIONS
+   and LANGUAGE are as for common_val_print.  */
+
+extern bool apply_builtin_libstdcxx_printer
+  (struct value *val, struct ui_file *stream, int recurse,
+   const struct value_print_options *options,
+   const struct language_defn *language);
+
+#endif /* GDB_CP_BUILTIN_PRINTERS_H */
@@ -0,0 +1,418 @@
+/* Process-wide cache of demangled symbol names.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "demangle-cache.h"
+#include "build-id.h"
+#include "cli/cli-cmds.h"
+#include "command.h"
+#include "dwarf2/index-cache.h"
+#include "language.h"
+#include "minsyms.h"
+#include "objfiles.h"
+#include "observable.h"
+#include "gdbsupport/cxx-thread.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/unordered_map.h"
+#include "gdbsupport/unordered_set.h"
+#include "gdbsupport/version.h"
+
+/* Shared libraries built from the same sources instantiate the same
+   templates and inline functions, so the same linkage names show up
+   in many objfiles.  Demangling is a large part of the cost of reading
+   minimal symbols, so the result of demangling a name is remembered
+   while the program's objfiles are loaded, and reused whenever another
+   objfile holds the same name.  Only names that do demangle are
+   remembered: most names of C programs don't, and there is no point in
+   filling the cache with them.
+
+   When the index cache is enabled, the names demangled for an objfile
+   are also saved in the index cache directory, keyed by the build ID
+   of the objfile, and loaded back the next time an objfile with the
+   same build ID is read.  */
+
+/* When true, show debug messages about the demangle cache.  */
+static bool debug_demangle_cache = false;
+
+#define demangle_cache_debug_printf(fmt, ...) \
+  debug_prefixed_printf_cond (debug_demangle_cache, "demangle-cache", \
+			      fmt, ##__VA_ARGS__)
+
+/* Whether the demangle cache is used, for "maint set demangle-cache".  */
+static bool demangle_cache_enabled = true;
+
+/* The first line of the files the demangle cache is saved to.  The
+   GDB version is part of it, since the demangler can change from one
+   version to the next.  */
+#define DEMANGLE_CACHE_HEADER "GDB demangle cache 2 "
+
+/* The suffix of the files the demangle cache is saved to.  */
+#define DEMANGLE_CACHE_SUFFIX ".gdb-demangle"
+
+/* What demangling a linkage name gave.  */
+
+struct demangle_cache_entry
+{
+  /* The language of the symbol the name was demangled for.  */
+  enum language language;
+
+  /* The language the name was found to be in.  */
+  enum language result_language;
+
+  /* The demangled form of the name.  */
+  std::string demangled;
+};
+
+/* The cache is split into shards, each with its own lock, so that the
+   threads installing minimal symbols rarely wait for each other.  */
+
+#define DEMANGLE_CACHE_SHARDS 64
+
+/* The number of entries a shard may hold.  A shard that is full is
+   emptied before another entry is added to it, which bounds the memory
+   used by the cache to about a million names.  */
+
+#define DEMANGLE_CACHE_SHARD_SIZE 16384
+
+struct demangle_cache_shard
+{
+  gdb::mutex lock;
+  gdb::unordered_string_map<demangle_cache_entry> entries;
+};
+
+static demangle_cache_shard demangle_cache_shards[DEMANGLE_CACHE_SHARDS];
+
+/* Build IDs whose saved names were loaded already, and the lock
+   protecting it.  */
+
+static gdb::unordered_set<std::string> demangle_cache_loaded;
+static gdb::mutex demangle_cache_loaded_lock;
+
+/* Return the shard holding the entry for MANGLED.  */
+
+static demangle_cache_shard &
+demangle_cache_shard_for (std::string_view mangled)
+{
+  /* The shard is chosen from the top bits of the hash, so that it does
+     not correlate with the buckets the map picks from the low
+     bits.  */
+  std::uint64_t hash
+    = gdb::detail::unordered_string_map_hash () (mangled);
+  return demangle_cache_shards[(hash >> 58) % DEMANGLE_CACHE_SHARDS];
+}
+
+/* Record ENTRY for MANGLED in the cache.  */
+
+static void
+demangle_cache_insert (std::string_view mangled, demangle_cache_entry &&entry)
+{
+  demangle_cache_shard &shard = demangle_cache_shard_for (mangled);
+
+  gdb::lock_guard<gdb::mutex> guard (shard.lock);
+  if (shard.entries.size () >= DEMANGLE_CACHE_SHARD_SIZE
+      && shard.entries.find (mangled) == shard.entries.end ())
+    shard.entries.clear ();
+  shard.entries.insert_or_assign (std::string (mangled), std::move (entry));
+}
+
+/* Empty the cache, and let the saved names be loaded again.  */
+
+static void
+demangle_cache_clear ()
+{
+  for (demangle_cache_shard &shard : demangle_cache_shards)
+    {
+      gdb::lock_guard<gdb::mutex> guard (shard.lock);
+      shard.entries.clear ();
+    }
+
+  gdb::lock_guard<gdb::mutex> guard (demangle_cache_loaded_lock);
+  demangle_cache_loaded.clear ();
+}
+
+/* See demangle-cache.h.  */
+
+bool
+demangle_cache_lookup (const char *mangled, enum language language,
+		       enum language *result_language,
+		       gdb::unique_xmalloc_ptr<char> *demangled)
+{
+  if (!demangle_cache_enabled)
+    return false;
+
+  demangle_cache_shard &shard = demangle_cache_shard_for (mangled);
+
+  gdb::lock_guard<gdb::mutex> guard (shard.lock);
+  auto it = shard.entries.find (std::string_view (mangled));
+  if (it == shard.entries.end () || it->second.language != language)
+    return false;
+
+  *result_language = it->second.result_language;
+  demangled->reset (xstrdup (it->second.demangled.c_str ()));
+  return true;
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache_store (const char *mangled, enum language language,
+		      enum language result_language, const char *demangled)
+{
+  if (!demangle_cache_enabled || demangled == nullptr)
+    return;
+
+  demangle_cache_insert (mangled, { language, result_language, demangled });
+}
+
+/* Return the name of the file the demangle cache of the objfile with
+   build ID BUILD_ID is saved to.  */
+
+static std::string
+demangle_cache_filename (const bfd_build_id *build_id)
+{
+  return string_printf ("%s/%s%s", global_index_cache.directory ().c_str (),
+			build_id_to_string (build_id).c_str (),
+			DEMANGLE_CACHE_SUFFIX);
+}
+
+/* Return the build ID of OBJFILE if its demangled names may be loaded
+   from or saved to the index cache, or NULL otherwise.  */
+
+static const bfd_build_id *
+demangle_cache_build_id (objfile *objfile)
+{
+  if (!demangle_cache_enabled
+      || !global_index_cache.enabled ()
+      || global_index_cache.directory ().empty ())
+    return nullptr;
+
+  return build_id_bfd_get (objfile->obfd.get ());
+}
+
+/* Add the names in CONTENTS, the contents of the saved demangle cache
+   FILENAME, to the cache.  Return the number of names added.  */
+
+static size_t
+demangle_cache_parse (const std::string &contents, const char *filename)
+{
+  std::string_view text = contents;
+  std::string header = string_printf ("%s%s\n", DEMANGLE_CACHE_HEADER,
+				      version);
+  if (!startswith (text, header))
+    {
+      demangle_cache_debug_printf ("ignoring %s, saved by another version",
+				   filename);
+      return 0;
+    }
+  text.remove_prefix (header.size ());
+
+  /* Each line holds the language of the symbol, the language the name
+     was found to be in, the linkage name and the demangled name,
+     separated by tabs.  */
+  size_t count = 0;
+  while (!text.empty ())
+    {
+      size_t eol = text.find ('\n');
+      if (eol == std::string_view::npos)
+	break;
+      std::string_view line = text.substr (0, eol);
+      text.remove_prefix (eol + 1);
+
+      std::string_view fields[4];
+      size_t nfields = 0;
+      for (; nfields < 3; ++nfields)
+	{
+	  size_t tab = line.find ('\t');
+	  if (tab == std::string_view::npos)
+	    break;
+	  fields[nfields] = line.substr (0, tab);
+	  line.remove_prefix (tab + 1);
+	}
+      fields[nfields++] = line;
+      if (nfields != 4 || fields[2].empty ())
+	{
+	  demangle_cache_debug_printf ("malformed line in %s", filename);
+	  return count;
+	}
+
+      enum language language
+	= language_enum (std::string (fields[0]).c_str ());
+      enum language result_language
+	= language_enum (std::string (fields[1]).c_str ());
+      if (language == language_unknown && fields[0] != "unknown")
+	continue;
+      if (result_language == language_unknown && fields[1] != "unknown")
+	continue;
+
+      demangle_cache_insert (fields[2],
+			     { language, result_language,
+			       std::string (fields[3]) });
+      ++count;
+    }
+
+  return count;
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache_load_objfile (objfile *objfile)
+{
+  const bfd_build_id *build_id = demangle_cache_build_id (objfile);
+  if (build_id == nullptr)
+    return;
+
+  {
+    gdb::lock_guard<gdb::mutex> guard (demangle_cache_loaded_lock);
+    if (!demangle_cache_loaded.insert (build_id_to_string (build_id)).second)
+      return;
+  }
+
+  std::string filename = demangle_cache_filename (build_id);
+  std::optional<std::string> contents
+    = read_text_file_to_string (filename.c_str ());
+  if (!contents.has_value ())
+    return;
+
+  size_t count = demangle_cache_parse (*contents, filename.c_str ());
+  demangle_cache_debug_printf ("loaded %zu names for %s from %s", count,
+			       objfile_name (objfile), filename.c_str ());
+}
+
+/* See demangle-cache.h.  */
+
+void
+demangle_cache_save_objfile (objfile *objfile)
+{
+  const bfd_build_id *build_id = demangle_cache_build_id (objfile);
+  if (build_id == nullptr)
+    return;
+
+  std::string filename = demangle_cache_filename (build_id);
+  if (access (filename.c_str (), F_OK) == 0)
+    return;
+
+  /* Minimal symbols always start out with no language, see
+     minimal_symbol_reader::record_full, so that is the language they
+     are demangled for.  */
+  std::string contents = string_printf ("%s%s\n", DEMANGLE_CACHE_HEADER,
+					version);
+  gdb::unordered_set<std::string_view> seen;
+  size_t count = 0;
+  for (minimal_symbol *msym : objfile->msymbols ())
+    {
+      const char *mangled = msym->linkage_name ();
+      const char *demangled = msym->demangled_name ();
+
+      /* Names that cannot be written out are demangled again the next
+	 time.  Names without a demangled form are not cached.  */
+      if (demangled == nullptr
+	  || strpbrk (mangled, "\t\n") != nullptr
+	  || strchr (demangled, '\n') != nullptr)
+	continue;
+      if (!seen.insert (mangled).second)
+	continue;
+
+      string_appendf (contents, "%s\t%s\t%s\t%s\n",
+		      language_str (language_unknown),
+		      language_str (msym->language ()),
+		      mangled, demangled);
+      ++count;
+    }
+
+  if (!mkdir_recursive (global_index_cache.directory ().c_str ()))
+    {
+      demangle_cache_debug_printf ("could not create %s: %s",
+				   global_index_cache.directory ().c_str (),
+				   safe_strerror (errno));
+      return;
+    }
+
+  gdb::char_vector temp_path = make_temp_filename (filename);
+  gdb_file_up file (gdb_fopen_cloexec (temp_path.data (), "w"));
+  if (file == nullptr)
+    {
+      demangle_cache_debug_printf ("could not create %s: %s",
+				   temp_path.data (), safe_strerror (errno));
+      return;
+    }
+  gdb::unlinker unlink_temp (temp_path.data ());
+
+  if (fwrite (contents.data (), 1, contents.size (), file.get ())
+	!= contents.size ()
+      || fclose (file.release ()) != 0
+      || rename (temp_path.data (), filename.c_str ()) != 0)
+    {
+      demangle_cache_debug_printf ("could not store %s: %s",
+				   filename.c_str (), safe_strerror (errno));
+      return;
+    }
+
+  unlink_temp.keep ();
+  demangle_cache_debug_printf ("saved %zu names of %s to %s", count,
+			       objfile_name (objfile), filename.c_str ());
+}
+
+/* "maint set demangle-cache" handler.  */
+
+static void
+set_demangle_cache (const char *arg, int from_tty, cmd_list_element *c)
+{
+  /* Release the memory held by the cache, and let the saved names be
+     loaded again if it is turned back on.  */
+  if (!demangle_cache_enabled)
+    demangle_cache_clear ();
+}
+
+/* Empty the cache once the objfiles of a program space are all gone,
+   for instance when another program is loaded.  */
+
+static void
+demangle_cache_all_objfiles_removed (program_space *pspace)
+{
+  demangle_cache_clear ();
+}
+
+INIT_GDB_FILE (demangle_cache)
+{
+  add_setshow_boolean_cmd ("demangle-cache", class_maintenance,
+			   &demangle_cache_enabled, _("\
+Set whether demangled symbol names are shared between objfiles."), _("\
+Show whether demangled symbol names are shared between objfiles."), _("\
+When on, GDB remembers the demangled form of the linkage names it\n\
+demangles, and reuses it for every objfile holding the same name.  When\n\
+the index cache is enabled, the names are also saved to the index cache\n\
+directory and reused by later sessions.  Turning this off empties the\n\
+cache."),
+			   set_demangle_cache, nullptr,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
+  add_setshow_boolean_cmd ("demangle-cache", class_maintenance,
+			   &debug_demangle_cache, _("\
+Set display of demangle cache debug messages."), _("\
+Show display of demangle cache debug messages."), _("\
+When on, debugging output for the demangle cache is displayed."),
+			   nullptr, nullptr,
+			   &setdebuglist, &showdebuglist);
+
+  gdb::observers::all_objfiles_removed.attach
+    (demangle_cache_all_objfiles_removed, "demangle-cache");
+}
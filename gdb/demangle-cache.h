@@ -0,0 +1,59 @@
+/* Process-wide cache of demangled symbol names.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDB_DEMANGLE_CACHE_H
+#define GDB_DEMANGLE_CACHE_H
+
+struct objfile;
+
+/* Look up MANGLED, the linkage name of a symbol of language LANGUAGE,
+   in the demangle cache.  If it is there, set *RESULT_LANGUAGE to the
+   language the name was found to be in, and *DEMANGLED to its
+   demangled form, and return true.  Otherwise, return false.  This can
+   be called from worker threads.  */
+
+extern bool demangle_cache_lookup (const char *mangled,
+				   enum language language,
+				   enum language *result_language,
+				   gdb::unique_xmalloc_ptr<char> *demangled);
+
+/* Record in the demangle cache that MANGLED, the linkage name of a
+   symbol of language LANGUAGE, was found to be in language
+   RESULT_LANGUAGE and to demangle to DEMANGLED.  Nothing is recorded
+   if DEMANGLED is NULL.  This can be called from worker threads.  */
+
+extern void demangle_cache_store (const char *mangled,
+				  enum language language,
+				  enum language result_language,
+				  const char *demangled);
+
+/* If the index cache is enabled, add the names saved by
+   demangle_cache_save_objfile for an objfile with the same build ID as
+   OBJFILE, in this session or an earlier one, to the demangle
+   cache.  */
+
+extern void demangle_cache_load_objfile (struct objfile *objfile);
+
+/* If the index cache is enabled and has no demangled names for the
+   build ID of OBJFILE yet, save those of the minimal symbols of
+   OBJFILE in the index cache directory.  */
+
+extern void demangle_cache_save_objfile (struct objfile *objfile);
+
+#endif /* GDB_DEMANGLE_CACHE_H */
@@ -19,6 +19,7 @@
 
 #include "arch-utils.h"
 #include "event-top.h"
+#include "gdbsupport/unordered_map.h"
 #include "gdbsupport/unordered_set.h"
 #include "target.h"
 #include "value.h"
@@ -34,6 +35,8 @@
 #include "cli/cli-style.h"
 #include "objfiles.h"
 #include "inferior.h"
+#include "gdbthread.h"
+#include "observable.h"
 
 /* Disassemble functions.
    FIXME: We should get rid of all the duplicate code in gdb that does
@@ -142,6 +145,100 @@ struct dis_line_entry_hash
   { return std::hash<symtab *> () (x.symtab) + std::hash<int> () (x.line); }
 };
 
+/* The largest block of memory scoped_disassembly_prefetch reads from
+   the target at once.  */
+#define DISASSEMBLY_PREFETCH_MAX (1024 * 1024)
+
+/* The size of the blocks scoped_disassembly_prefetch reads when the end
+   of the disassembled range is not known.  */
+#define DISASSEMBLY_PREFETCH_CHUNK 4096
+
+/* How far past the end of the disassembled range scoped_disassembly_prefetch
+   reads, so that the last instruction of the range is in the block too.  */
+#define DISASSEMBLY_PREFETCH_SLACK 64
+
+scoped_disassembly_prefetch *scoped_disassembly_prefetch::s_current;
+
+/* See disasm.h.  */
+
+scoped_disassembly_prefetch::scoped_disassembly_prefetch (CORE_ADDR low,
+							  CORE_ADDR high)
+  : m_low (low),
+    m_high (high),
+    m_prev (s_current)
+{
+  s_current = this;
+}
+
+/* See disasm.h.  */
+
+scoped_disassembly_prefetch::~scoped_disassembly_prefetch ()
+{
+  gdb_assert (s_current == this);
+  s_current = m_prev;
+}
+
+/* See disasm.h.  */
+
+bool
+scoped_disassembly_prefetch::read (CORE_ADDR memaddr, gdb_byte *myaddr,
+				   ULONGEST len)
+{
+  if (memaddr < m_low)
+    return false;
+
+  if (memaddr >= m_block_start
+      && memaddr - m_block_start + len <= m_block.size ())
+    {
+      memcpy (myaddr, m_block.data () + (memaddr - m_block_start), len);
+      return true;
+    }
+
+  /* Blocks are read as TARGET_OBJECT_MEMORY, which counts bytes.  */
+  if (gdbarch_addressable_memory_unit_size (current_inferior ()->arch ())
+      != 1)
+    return false;
+
+  ULONGEST size;
+  if (m_high > m_low)
+    {
+      if (memaddr >= m_high)
+	{
+	  if (memaddr - m_high >= DISASSEMBLY_PREFETCH_SLACK)
+	    return false;
+	  size = DISASSEMBLY_PREFETCH_SLACK;
+	}
+      else
+	size = std::min<ULONGEST> (m_high - memaddr
+				   + DISASSEMBLY_PREFETCH_SLACK,
+				   DISASSEMBLY_PREFETCH_MAX);
+    }
+  else
+    size = DISASSEMBLY_PREFETCH_CHUNK;
+  size = std::max (size, len);
+
+  /* Don't wrap around the end of the address space.  */
+  if (memaddr + size < memaddr)
+    size = -memaddr;
+
+  /* TARGET_OBJECT_MEMORY still shows the contents shadowed by inserted
+     breakpoints, but bypasses the code cache, which would split the
+     block into many small reads.  A block that is only partly readable
+     is kept up to the first unreadable byte.  */
+  m_block.resize (size);
+  LONGEST n = target_read (current_inferior ()->top_target (),
+			   TARGET_OBJECT_MEMORY, nullptr, m_block.data (),
+			   memaddr, size);
+  m_block_start = memaddr;
+  m_block.resize (std::max<LONGEST> (n, 0));
+
+  if (m_block.size () < len)
+    return false;
+
+  memcpy (myaddr, m_block.data (), len);
+  return true;
+}
+
 /* Wrapper of target_read_code.  */
 
 int
@@ -151,6 +248,11 @@ gdb_disassembler_memory_reader::dis_asm_read_memory
 {
   auto res = catch_exceptions<int, -1> ([&]
     {
+      scoped_disassembly_prefetch *prefetch
+	= scoped_disassembly_prefetch::current ();
+      if (prefetch != nullptr && prefetch->read (memaddr, myaddr, len))
+	return 0;
+
       return target_read_code (memaddr, myaddr, len);
     });
 
@@ -426,7 +528,11 @@ gdb_pretty_print_disassembler::pretty_print_insn (const struct disasm_insn *insn
 
 	/* Read the instruction opcode data.  */
 	m_opcode_data.resize (size);
-	read_code (pc, m_opcode_data.data (), size);
+	scoped_disassembly_prefetch *prefetch
+	  = scoped_disassembly_prefetch::current ();
+	if (prefetch == nullptr
+	    || !prefetch->read (pc, m_opcode_data.data (), size))
+	  read_code (pc, m_opcode_data.data (), size);
 
 	/* The disassembler provides information about the best way to
 	   display the instruction bytes to the user.  We provide some sane
@@ -1149,6 +1255,10 @@ gdb_disassembly (struct gdbarch *gdbarch, struct ui_out *uiout,
   struct symtab *symtab;
   int nlines = -1;
 
+  /* Read the code to disassemble in large blocks, instead of an
+     instruction at a time.  */
+  scoped_disassembly_prefetch prefetch (low, high);
+
   /* Assume symtab is valid for whole PC range.  */
   symtab = find_symtab_for_pc (low);
 
@@ -1193,6 +1303,65 @@ gdb_insn_length (struct gdbarch *gdbarch, CORE_ADDR addr)
   return gdb_print_insn (gdbarch, addr, &null_stream, NULL);
 }
 
+/* The key of insn_length_cache.  */
+
+struct insn_length_key
+{
+  bool operator== (const insn_length_key &other) const noexcept
+  {
+    return (this->pspace == other.pspace
+	    && this->gdbarch == other.gdbarch
+	    && this->addr == other.addr);
+  }
+
+  program_space *pspace;
+  struct gdbarch *gdbarch;
+  CORE_ADDR addr;
+};
+
+/* Hash function for insn_length_key.  */
+
+struct insn_length_key_hash
+{
+  std::size_t operator() (const insn_length_key &x) const noexcept
+  {
+    return (std::hash<CORE_ADDR> () (x.addr)
+	    + std::hash<struct gdbarch *> () (x.gdbarch));
+  }
+};
+
+/* The lengths of the instructions decoded by gdb_cached_insn_length.  */
+
+static gdb::unordered_map<insn_length_key, int, insn_length_key_hash>
+  insn_length_cache;
+
+/* The number of entries past which insn_length_cache is emptied.  */
+#define INSN_LENGTH_CACHE_MAX 65536
+
+/* See disasm.h.  */
+
+int
+gdb_cached_insn_length (struct gdbarch *gdbarch, CORE_ADDR addr)
+{
+  /* Code can change under our feet while threads run.  */
+  process_stratum_target *proc_target = current_inferior ()->process_target ();
+  if (proc_target != nullptr && threads_are_executing (proc_target))
+    return gdb_insn_length (gdbarch, addr);
+
+  insn_length_key key { current_program_space, gdbarch, addr };
+  auto it = insn_length_cache.find (key);
+  if (it != insn_length_cache.end ())
+    return it->second;
+
+  int length = gdb_insn_length (gdbarch, addr);
+
+  if (insn_length_cache.size () >= INSN_LENGTH_CACHE_MAX)
+    insn_length_cache.clear ();
+  insn_length_cache.emplace (key, length);
+
+  return length;
+}
+
 /* See disasm.h.  */
 
 int
@@ -1477,6 +1646,24 @@ disassembler_options_completer (struct cmd_list_element *ignore,
 
 INIT_GDB_FILE (disasm)
 {
+  /* The cached instruction lengths are dropped whenever the code could
+     have changed, and whenever the prompt is shown, so that commands
+     changing how instructions decode, like "set disassembler-options"
+     or "set arm force-mode", take effect.  */
+  gdb::observers::before_prompt.attach
+    ([] (const char *) { insn_length_cache.clear (); }, "disasm");
+  gdb::observers::target_resumed.attach
+    ([] (ptid_t) { insn_length_cache.clear (); }, "disasm");
+  gdb::observers::memory_changed.attach
+    ([] (inferior *, CORE_ADDR, ssize_t, const bfd_byte *)
+     { insn_length_cache.clear (); }, "disasm");
+  gdb::observers::new_objfile.attach
+    ([] (objfile *) { insn_length_cache.clear (); }, "disasm");
+  gdb::observers::free_objfile.attach
+    ([] (objfile *) { insn_length_cache.clear (); }, "disasm");
+  gdb::observers::inferior_exit.attach
+    ([] (inferior *) { insn_length_cache.clear (); }, "disasm");
+
   /* Add the command that controls the disassembler options.  */
   set_show_commands set_show_disas_opts
     = add_setshow_string_noescape_cmd ("disassembler-options", no_class,
@@ -22,6 +22,7 @@
 #include "dis-asm.h"
 #include "disasm-flags.h"
 #include "ui-out.h"
+#include "gdbsupport/byte-vector.h"
 
 struct gdbarch;
 struct ui_out;
@@ -377,6 +378,57 @@ class gdb_pretty_print_disassembler
 
 extern int gdb_insn_length (struct gdbarch *gdbarch, CORE_ADDR memaddr);
 
+/* Like gdb_insn_length, but remember the length of the instruction at
+   MEMADDR until the target resumes, memory or the objfiles change, or
+   GDB next shows its prompt.  This is for callers that decode the same
+   instructions again and again, like the TUI does when scrolling the
+   disassembly backwards.  */
+
+extern int gdb_cached_insn_length (struct gdbarch *gdbarch,
+				   CORE_ADDR memaddr);
+
+/* While an object of this type is live, the instructions disassembled
+   from target memory, and their raw bytes, are read from blocks of
+   memory fetched from the target in one go, rather than a few bytes at
+   a time.  LOW and HIGH bound the addresses that are going to be
+   disassembled; HIGH is zero if that is not known in advance.  The
+   target must not resume while the object is live.  */
+
+class scoped_disassembly_prefetch
+{
+public:
+  explicit scoped_disassembly_prefetch (CORE_ADDR low, CORE_ADDR high = 0);
+  ~scoped_disassembly_prefetch ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_disassembly_prefetch);
+
+  /* Copy the LEN bytes of target memory at MEMADDR to MYADDR, fetching
+     a new block from the target if needed.  Return false if the bytes
+     are not all readable in a block, in which case the caller should
+     read them directly to get the proper error.  */
+  bool read (CORE_ADDR memaddr, gdb_byte *myaddr, ULONGEST len);
+
+  /* The innermost live object, or NULL.  */
+  static scoped_disassembly_prefetch *current ()
+  { return s_current; }
+
+private:
+  /* The bounds passed to the constructor.  */
+  CORE_ADDR m_low;
+  CORE_ADDR m_high;
+
+  /* The address of the first byte of M_BLOCK.  */
+  CORE_ADDR m_block_start = 0;
+
+  /* The last block of memory fetched from the target.  */
+  gdb::byte_vector m_block;
+
+  /* The object that was current before this one.  */
+  scoped_disassembly_prefetch *m_prev;
+
+  static scoped_disassembly_prefetch *s_current;
+};
+
 /* Return the length in bytes of INSN, originally at MEMADDR.  MAX_LEN
    is the size of the buffer containing INSN.  */
 
@@ -83,6 +83,12 @@ class index_cache
   /* Disable the cache.  */
   void disable ();
 
+  /* Return the directory used to save/load index files.  */
+  const std::string &directory () const
+  {
+    return m_dir;
+  }
+
   /* Look for an index file matching BUILD_ID.  If found, return the contents
      as an array_view and store the underlying resources (allocated memory,
      mapped file, etc) in RESOURCE.  The returned array_view is valid as long
@@ -24,6 +24,7 @@
 #include "target.h"
 #include "auto-load.h"
 #include "breakpoint.h"
+#include "cp-builtin-printers.h"
 #include "event-top.h"
 #include "extension.h"
 #include "extension-priv.h"
@@ -455,9 +456,10 @@ ext_lang_type_printers::~ext_lang_type_printers ()
    OPTIONS.  VAL is the object to print.  Returns non-zero if the
    value was successfully pretty-printed.
 
-   Extension languages are tried in the order specified by
-   extension_languages.  The first one to provide a pretty-printed
-   value "wins".
+   GDB's built-in printers for libstdc++ containers, when enabled, are
+   tried first.  Extension languages are then tried in the order
+   specified by extension_languages.  The first one to provide a
+   pretty-printed value "wins".
 
    If an error is encountered in a pretty-printer, no further extension
    languages are tried.
@@ -471,6 +473,10 @@ apply_ext_lang_val_pretty_printer (struct value *val,
 				   const struct value_print_options *options,
 				   const struct language_defn *language)
 {
+  if (apply_builtin_libstdcxx_printer (val, stream, recurse, options,
+				       language))
+    return 1;
+
   for (const struct extension_language_defn *extlang : extension_languages)
     {
       enum ext_lang_rc rc;
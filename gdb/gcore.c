@@ -28,6 +28,7 @@
 #include "completer.h"
 #include "gcore.h"
 #include "cli/cli-decode.h"
+#include "cli/cli-option.h"
 #include <fcntl.h>
 #include "regcache.h"
 #include "regset.h"
@@ -35,8 +36,12 @@
 #include <algorithm>
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/byte-vector.h"
+#include "gdbsupport/gdb_vecs.h"
 #include "gdbsupport/scope-exit.h"
 #include "auxv.h"
+#include "extract-store-integer.h"
+#include "gdbthread.h"
+#include "value.h"
 
 /* To generate sparse cores, we look at the data to write in chunks of
    this size when considering whether to skip the write.  Only if we
@@ -54,6 +59,27 @@
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (256 * SPARSE_BLOCK_SIZE)
 
+/* The default number of bytes of each thread's stack saved in a
+   compact core file.  */
+#define GCORE_COMPACT_STACK_SIZE (256 * 1024)
+
+/* The default number of bytes saved in a compact core file from each
+   address found in a register or on a stack.  */
+#define GCORE_COMPACT_RADIUS 256
+
+/* An address range [START, END) of the inferior's memory.  */
+
+struct gcore_range
+{
+  CORE_ADDR start;
+  CORE_ADDR end;
+};
+
+/* When writing a compact core file, the sorted, disjoint ranges of
+   memory to save.  Memory outside these ranges is left out of the
+   core file.  */
+static const std::vector<gcore_range> *gcore_compact_ranges;
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static int gcore_memory_sections (bfd *);
@@ -134,6 +160,277 @@ write_gcore_file (bfd *obfd)
   write_gcore_file_1 (obfd);
 }
 
+/* The options for the "generate-core-file" command.  */
+
+struct gcore_opts
+{
+  /* For "-compact".  */
+  bool compact = false;
+
+  /* For "-stack-size".  */
+  unsigned int stack_size = GCORE_COMPACT_STACK_SIZE;
+
+  /* For "-radius".  */
+  unsigned int radius = GCORE_COMPACT_RADIUS;
+
+  /* For "-regions".  */
+  std::string regions;
+};
+
+static const gdb::option::option_def gcore_option_defs[] = {
+
+  gdb::option::flag_option_def<gcore_opts> {
+    "compact",
+    [] (gcore_opts *opts) { return &opts->compact; },
+    N_("\
+Only save the memory needed to examine the threads' stacks, instead\n\
+of all the writable memory of the process.  When the core file is\n\
+read, global variables that were not saved read as their initial\n\
+values in the executable, not as the values they had; use -regions\n\
+to save them."),
+  },
+
+  gdb::option::uinteger_option_def<gcore_opts> {
+    "stack-size",
+    [] (gcore_opts *opts) { return &opts->stack_size; },
+    nullptr, /* show_cmd_cb */
+    N_("\
+The number of bytes of each thread's stack to save, starting from\n\
+its stack pointer, with -compact.  The default is 262144."),
+  },
+
+  gdb::option::uinteger_option_def<gcore_opts> {
+    "radius",
+    [] (gcore_opts *opts) { return &opts->radius; },
+    nullptr, /* show_cmd_cb */
+    N_("\
+The number of bytes to save from each address found in a register\n\
+or on a saved stack, with -compact.  The default is 256."),
+  },
+
+  gdb::option::string_option_def<gcore_opts> {
+    "regions",
+    [] (gcore_opts *opts) { return &opts->regions; },
+    nullptr, /* show_cmd_cb */
+    N_("\
+A list of expressions separated by semicolons, naming objects in\n\
+memory to save in addition, with -compact."),
+  },
+
+};
+
+/* Create an option_def_group for the "generate-core-file" command's
+   options, with OPTS as context.  */
+
+static inline gdb::option::option_def_group
+make_gcore_options_def_group (gcore_opts *opts)
+{
+  return {{gcore_option_defs}, opts};
+}
+
+/* Call FUNC with DATA for each memory region of the inferior.  Try the
+   gdbarch method first, then fall back to the target method.  Return
+   non-zero on failure.  */
+
+static int
+gcore_find_memory_regions (find_memory_region_ftype func, void *data)
+{
+  gdbarch *arch = current_inferior ()->arch ();
+  if (gdbarch_find_memory_regions_p (arch)
+      && gdbarch_find_memory_regions (arch, func, data) == 0)
+    return 0;
+
+  return target_find_memory_regions (func, data);
+}
+
+/* find_memory_region_ftype implementation collecting the readable
+   regions of memory.
+
+   DATA is the 'std::vector<gcore_range> *' to add them to.  */
+
+static int
+gcore_collect_region_callback (CORE_ADDR vaddr, unsigned long size,
+			       bool read, bool write, bool exec,
+			       bool modified, bool memory_tagged, void *data)
+{
+  auto *regions = (std::vector<gcore_range> *) data;
+
+  if (read && size > 0)
+    regions->push_back ({ vaddr, vaddr + size });
+  return 0;
+}
+
+/* Return the ranges of memory to save in a compact core file, as
+   selected by OPTS.
+
+   These are, for each thread, the STACK_SIZE bytes of its stack above
+   its stack pointer (plus the red zone below it); RADIUS bytes from
+   each address held in one of its integer registers or found on the
+   saved part of its stack; the objects named by REGIONS; and the
+   memory the solib layer needs to rebuild the list of shared
+   libraries.  Code and read-only data are not included: they are
+   found from the executable and shared libraries instead, as in
+   regular core files.  */
+
+static std::vector<gcore_range>
+gcore_compute_compact_ranges (const gcore_opts &opts)
+{
+  std::vector<gcore_range> regions;
+  if (gcore_find_memory_regions (gcore_collect_region_callback,
+				 &regions) != 0)
+    error (_("Couldn't find the memory regions of the process."));
+  std::sort (regions.begin (), regions.end (),
+	     [] (const gcore_range &a, const gcore_range &b)
+	     {
+	       return a.start < b.start;
+	     });
+
+  /* Return the region containing ADDR, or nullptr.  */
+  auto find_region = [&] (CORE_ADDR addr) -> const gcore_range *
+    {
+      auto it = std::upper_bound (regions.begin (), regions.end (), addr,
+				  [] (CORE_ADDR a, const gcore_range &r)
+				  {
+				    return a < r.start;
+				  });
+      if (it == regions.begin () || addr >= (it - 1)->end)
+	return nullptr;
+      return &*(it - 1);
+    };
+
+  std::vector<gcore_range> ranges;
+
+  /* Add [LO, HI), clipped to the region containing ADDR, if any.  */
+  auto add_range = [&] (CORE_ADDR addr, CORE_ADDR lo, CORE_ADDR hi)
+    {
+      const gcore_range *region = find_region (addr);
+      if (region == nullptr)
+	return;
+
+      lo = std::max (lo, region->start);
+      hi = std::min (hi, region->end);
+      if (lo < hi)
+	ranges.push_back ({ lo, hi });
+    };
+
+  auto add_pointer = [&] (CORE_ADDR addr)
+    {
+      add_range (addr, addr, addr + opts.radius);
+    };
+
+  for (thread_info &thr : current_inferior ()->non_exited_threads ())
+    {
+      regcache *regcache = get_thread_regcache (&thr);
+      gdbarch *gdbarch = regcache->arch ();
+      int ptr_size = gdbarch_ptr_bit (gdbarch) / TARGET_CHAR_BIT;
+      bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+
+      for (int regnum = 0; regnum < gdbarch_num_regs (gdbarch); regnum++)
+	{
+	  type *reg_type = register_type (gdbarch, regnum);
+	  ULONGEST val;
+
+	  if ((reg_type->code () == TYPE_CODE_INT
+	       || reg_type->code () == TYPE_CODE_PTR)
+	      && reg_type->length () == ptr_size
+	      && regcache_cooked_read_unsigned (regcache, regnum,
+						&val) == REG_VALID)
+	    add_pointer (val);
+	}
+
+      int sp_regnum = gdbarch_sp_regnum (gdbarch);
+      ULONGEST sp;
+      if (sp_regnum < 0
+	  || regcache_cooked_read_unsigned (regcache, sp_regnum,
+					    &sp) != REG_VALID)
+	continue;
+
+      CORE_ADDR red_zone = gdbarch_frame_red_zone_size (gdbarch);
+      CORE_ADDR lo, hi;
+      if (gdbarch_inner_than (gdbarch, 1, 2))
+	{
+	  lo = sp - red_zone;
+	  hi = sp + opts.stack_size;
+	}
+      else
+	{
+	  lo = sp - opts.stack_size;
+	  hi = sp + red_zone;
+	}
+
+      size_t stack_index = ranges.size ();
+      add_range (sp, lo, hi);
+      if (ranges.size () == stack_index)
+	continue;
+
+      /* Follow the addresses found on the saved part of the stack.  */
+      gcore_range stack = ranges[stack_index];
+      gdb::byte_vector stack_data (stack.end - stack.start);
+      if (target_read_memory (stack.start, stack_data.data (),
+			      stack_data.size ()) != 0)
+	continue;
+
+      size_t offset = -stack.start & (ptr_size - 1);
+      for (; offset + ptr_size <= stack_data.size (); offset += ptr_size)
+	add_pointer (extract_unsigned_integer (&stack_data[offset],
+					       ptr_size, byte_order));
+    }
+
+  /* The objects the user asked for.  */
+  for (const gdb::unique_xmalloc_ptr<char> &expr
+	 : delim_string_to_char_ptr_vec (opts.regions.c_str (), ';'))
+    {
+      const char *exp = skip_spaces (expr.get ());
+      if (*exp == '\0')
+	continue;
+
+      value *val = parse_and_eval (exp);
+      if (val->lval () != lval_memory)
+	error (_("\"%s\" is not an object in memory."), exp);
+      CORE_ADDR addr = val->address ();
+      ranges.push_back ({ addr, addr + val->type ()->length () });
+    }
+
+  std::vector<mem_range> solib_ranges;
+  solib_core_file_memory_ranges (solib_ranges);
+  for (const mem_range &r : solib_ranges)
+    add_range (r.start, r.start, r.start + r.length);
+
+  /* Sort the ranges, and coalesce those that overlap or are close
+     enough that a separate segment would cost more than the gap.  */
+  std::sort (ranges.begin (), ranges.end (),
+	     [] (const gcore_range &a, const gcore_range &b)
+	     {
+	       return a.start < b.start;
+	     });
+
+  std::vector<gcore_range> merged;
+  for (const gcore_range &r : ranges)
+    if (!merged.empty () && r.start <= merged.back ().end + opts.radius)
+      merged.back ().end = std::max (merged.back ().end, r.end);
+    else
+      merged.push_back (r);
+
+  return merged;
+}
+
+/* Completer for the "generate-core-file" command.  */
+
+static void
+gcore_command_completer (struct cmd_list_element *ignore,
+			 completion_tracker &tracker,
+			 const char *text, const char *word)
+{
+  auto grp = make_gcore_options_def_group (nullptr);
+  if (gdb::option::complete_options
+      (tracker, &text, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_OPERAND, grp))
+    return;
+
+  /* The file name is the rest of the line, and is not quoted.  */
+  word = advance_to_deprecated_filename_complete_word_point (tracker, text);
+  deprecated_filename_completer (ignore, tracker, text, word);
+}
+
 /* gcore_command -- implements the 'gcore' command.
    Generate a core file from the inferior process.  */
 
@@ -146,6 +443,11 @@ gcore_command (const char *args, int from_tty)
   if (!target_has_execution ())
     noprocess ();
 
+  gcore_opts opts;
+  auto grp = make_gcore_options_def_group (&opts);
+  gdb::option::process_options
+    (&args, gdb::option::PROCESS_OPTIONS_UNKNOWN_IS_OPERAND, grp);
+
   if (args && *args)
     corefilename = gdb_rl_tilde_expand (args);
   else
@@ -158,7 +460,16 @@ gcore_command (const char *args, int from_tty)
     gdb_printf ("Opening corefile '%s' for output.\n",
 		corefilename.get ());
 
-  if (target_supports_dumpcore ())
+  std::vector<gcore_range> compact_ranges;
+  scoped_restore restore_compact_ranges
+    = make_scoped_restore (&gcore_compact_ranges);
+  if (opts.compact)
+    {
+      compact_ranges = gcore_compute_compact_ranges (opts);
+      gcore_compact_ranges = &compact_ranges;
+    }
+
+  if (!opts.compact && target_supports_dumpcore ())
     target_dumpcore (corefilename.get ());
   else
     {
@@ -176,6 +487,10 @@ gcore_command (const char *args, int from_tty)
     }
 
   gdb_printf ("Saved corefile %s\n", corefilename.get ());
+  if (opts.compact && from_tty)
+    gdb_printf (_("Note: global variables that were not saved read as "
+		  "their initial\nvalues in the executable; use -regions "
+		  "to save them.\n"));
 }
 
 static enum bfd_architecture
@@ -390,6 +705,61 @@ make_output_phdrs (bfd *obfd, asection *osec)
   bfd_record_phdr (obfd, p_type, 1, p_flags, 0, 0, 0, 0, 1, &osec);
 }
 
+/* Create a "load" section with FLAGS for the SIZE bytes of memory at
+   VADDR in the core file OBFD.  Return false on failure.  */
+
+static bool
+gcore_make_load_section (bfd *obfd, flagword flags, CORE_ADDR vaddr,
+			 ULONGEST size)
+{
+  asection *osec = bfd_make_section_anyway_with_flags (obfd, "load", flags);
+  if (osec == NULL)
+    {
+      warning (_("Couldn't make gcore segment: %s"),
+	       bfd_errmsg (bfd_get_error ()));
+      return false;
+    }
+
+  if (info_verbose)
+    gdb_printf ("Save segment, %s bytes at %s\n",
+		pulongest (size), paddress (current_inferior ()->arch (),
+		vaddr));
+
+  bfd_set_section_size (osec, size);
+  bfd_set_section_vma (osec, vaddr);
+  bfd_set_section_lma (osec, 0);
+  return true;
+}
+
+/* Call FUNC with the bounds [LO, HI) of each part of the SIZE bytes of
+   memory at VADDR that is selected for a compact core file, in
+   ascending order.  Stop and return FUNC's result as soon as it
+   returns non-zero; otherwise return zero.  */
+
+template<typename Func>
+static int
+gcore_for_each_compact_range (CORE_ADDR vaddr, ULONGEST size, Func func)
+{
+  CORE_ADDR end = vaddr + size;
+  auto it = std::upper_bound (gcore_compact_ranges->begin (),
+			      gcore_compact_ranges->end (), vaddr,
+			      [] (CORE_ADDR a, const gcore_range &r)
+			      {
+				return a < r.start;
+			      });
+  if (it != gcore_compact_ranges->begin () && (it - 1)->end > vaddr)
+    --it;
+
+  for (; it != gcore_compact_ranges->end () && it->start < end; ++it)
+    {
+      int ret = func (std::max (vaddr, it->start), std::min (end, it->end));
+      if (ret != 0)
+	return ret;
+    }
+
+  return 0;
+}
+
 /* find_memory_region_ftype implementation.
 
    MEMORY_TAGGED is true if the memory region contains memory tags, false
@@ -403,7 +773,6 @@ gcore_create_callback (CORE_ADDR vaddr, unsigned long size, bool read,
 		       void *data)
 {
   bfd *obfd = (bfd *) data;
-  asection *osec;
   flagword flags = SEC_ALLOC | SEC_HAS_CONTENTS | SEC_LOAD;
 
   /* If the memory segment has no permissions set, ignore it, otherwise
@@ -461,44 +830,27 @@ gcore_create_callback (CORE_ADDR vaddr, unsigned long size, bool read,
   else
     flags |= SEC_DATA;
 
-  osec = bfd_make_section_anyway_with_flags (obfd, "load", flags);
-  if (osec == NULL)
+  if (gcore_compact_ranges != nullptr && (flags & SEC_LOAD) != 0)
     {
-      warning (_("Couldn't make gcore segment: %s"),
-	       bfd_errmsg (bfd_get_error ()));
-      return 1;
+      /* Only save the parts of the region selected for a compact
+	 core file.  */
+      return gcore_for_each_compact_range
+	(vaddr, size,
+	 [&] (CORE_ADDR lo, CORE_ADDR hi)
+	 {
+	   return gcore_make_load_section (obfd, flags, lo, hi - lo) ? 0 : 1;
+	 });
     }
 
-  if (info_verbose)
-    gdb_printf ("Save segment, %s bytes at %s\n",
-		plongest (size), paddress (current_inferior ()->arch (),
-		vaddr));
-
-  bfd_set_section_size (osec, size);
-  bfd_set_section_vma (osec, vaddr);
-  bfd_set_section_lma (osec, 0);
-  return 0;
+  return gcore_make_load_section (obfd, flags, vaddr, size) ? 0 : 1;
 }
 
-/* gdbarch_find_memory_region callback for creating a memory tag section.
-
-   MEMORY_TAGGED is true if the memory region contains memory tags, false
-   otherwise.
-
-   DATA is 'bfd *' for the core file GDB is creating.  */
+/* Create a memory tag section in the core file OBFD for the SIZE bytes
+   of memory at VADDR.  Return non-zero on failure.  */
 
 static int
-gcore_create_memtag_section_callback (CORE_ADDR vaddr, unsigned long size,
-				      bool read, bool write, bool exec,
-				      bool modified, bool memory_tagged,
-				      void *data)
+gcore_create_memtag_section (bfd *obfd, CORE_ADDR vaddr, ULONGEST size)
 {
-  /* Are there memory tags in this particular memory map entry?  */
-  if (!memory_tagged)
-    return 0;
-
-  bfd *obfd = (bfd *) data;
-
   /* Ask the architecture to create a memory tag section for this particular
      memory map entry.  It will be populated with contents later, as we can't
      start writing the contents before we have all the sections sorted out.  */
@@ -524,6 +876,38 @@ gcore_create_memtag_section_callback (CORE_ADDR vaddr, unsigned long size,
   return 0;
 }
 
+/* gdbarch_find_memory_region callback for creating a memory tag section.
+
+   MEMORY_TAGGED is true if the memory region contains memory tags, false
+   otherwise.
+
+   DATA is 'bfd *' for the core file GDB is creating.  */
+
+static int
+gcore_create_memtag_section_callback (CORE_ADDR vaddr, unsigned long size,
+				      bool read, bool write, bool exec,
+				      bool modified, bool memory_tagged,
+				      void *data)
+{
+  /* Are there memory tags in this particular memory map entry?  */
+  if (!memory_tagged)
+    return 0;
+
+  bfd *obfd = (bfd *) data;
+
+  /* In a compact core file, only the tags of the memory that is saved
+     are saved.  */
+  if (gcore_compact_ranges != nullptr)
+    return gcore_for_each_compact_range
+      (vaddr, size,
+       [&] (CORE_ADDR lo, CORE_ADDR hi)
+       {
+	 return gcore_create_memtag_section (obfd, lo, hi - lo);
+       });
+
+  return gcore_create_memtag_section (obfd, vaddr, size);
+}
+
 int
 objfile_find_memory_regions (struct target_ops *self,
 			     find_memory_region_ftype func, void *obfd)
@@ -847,24 +1231,13 @@ gcore_copy_memtag_section_callback (bfd *obfd, asection *osec)
 static int
 gcore_memory_sections (bfd *obfd)
 {
-  /* Try gdbarch method first, then fall back to target method.  */
-  gdbarch *arch = current_inferior ()->arch ();
-  if (!gdbarch_find_memory_regions_p (arch)
-      || gdbarch_find_memory_regions (arch, gcore_create_callback, obfd) != 0)
-    {
-      if (target_find_memory_regions (gcore_create_callback, obfd) != 0)
-	return 0;			/* FIXME: error return/msg?  */
-    }
+  if (gcore_find_memory_regions (gcore_create_callback, obfd) != 0)
+    return 0;			/* FIXME: error return/msg?  */
 
   /* Take care of dumping memory tags, if there are any.  */
-  if (!gdbarch_find_memory_regions_p (arch)
-      || gdbarch_find_memory_regions (arch, gcore_create_memtag_section_callback,
-				      obfd) != 0)
-    {
-      if (target_find_memory_regions (gcore_create_memtag_section_callback,
-				      obfd) != 0)
-	return 0;
-    }
+  if (gcore_find_memory_regions (gcore_create_memtag_section_callback,
+				 obfd) != 0)
+    return 0;
 
   /* Record phdrs for section-to-segment mapping.  */
   for (asection *sect : gdb_bfd_sections (obfd))
@@ -903,11 +1276,21 @@ gcore_find_signalled_thread ()
 
 INIT_GDB_FILE (gcore)
 {
-  cmd_list_element *generate_core_file_cmd
-    = add_com ("generate-core-file", class_files, gcore_command, _("\
+  auto grp = make_gcore_options_def_group (nullptr);
+  static std::string generate_core_file_help
+    = gdb::option::build_help (_("\
 Save a core file with the current state of the debugged process.\n\
-Usage: generate-core-file [FILENAME]\n\
-Argument is optional filename.  Default filename is 'core.PROCESS_ID'."));
+Usage: generate-core-file [OPTION]... [FILENAME]\n\
+Argument is optional filename.  Default filename is 'core.PROCESS_ID'.\n\
+\n\
+Options:\n\
+%OPTIONS%"),
+			       grp);
+  cmd_list_element *generate_core_file_cmd
+    = add_com ("generate-core-file", class_files, gcore_command,
+	       generate_core_file_help.c_str ());
+  set_cmd_completer_handle_brkchars (generate_core_file_cmd,
+				    gcore_command_completer);
 
   add_com_alias ("gcore", generate_core_file_cmd, class_files, 1);
 }
@@ -36,6 +36,8 @@
 #include "gdbsupport/cxx-thread.h"
 #include "gdbsupport/unordered_map.h"
 #include "gdbsupport/unordered_set.h"
+#include "build-id.h"
+#include "target-file-cache.h"
 
 /* Lock held when doing BFD operations.  A recursive mutex is used
    because we use this mutex internally and also for BFD, just to make
@@ -378,6 +380,10 @@ struct target_fileio_stream : public gdb_bfd_iovec_base
 
   int stat (struct bfd *abfd, struct stat *sb) override;
 
+  /* If ABFD, the BFD read through this stream, is an object file with
+     a build ID, switch to reading it from the target file cache.  */
+  void use_target_file_cache (bfd *abfd);
+
 private:
 
   /* The BFD.  Saved for the destructor.  */
@@ -385,6 +391,11 @@ struct target_fileio_stream : public gdb_bfd_iovec_base
 
   /* The file descriptor.  */
   target_fd m_fd;
+
+  /* A file descriptor open on a local copy of the file, from the
+     target file cache.  When valid, reads are served from it rather
+     than from the target.  */
+  scoped_fd m_local_fd;
 };
 
 /* Wrapper for target_fileio_open suitable for use as a helper
@@ -413,7 +424,8 @@ gdb_bfd_iovec_fileio_open (struct bfd *abfd, inferior *inf, bool warn_if_slow)
   return new target_fileio_stream (abfd, fd);
 }
 
-/* Wrapper for target_fileio_pread.  */
+/* Wrapper for target_fileio_pread, or for reading the local copy of
+   the file from the target file cache.  */
 
 file_ptr
 target_fileio_stream::read (struct bfd *abfd, void *buf,
@@ -422,6 +434,41 @@ target_fileio_stream::read (struct bfd *abfd, void *buf,
   fileio_error target_errno;
   file_ptr pos, bytes;
 
+  if (m_local_fd.get () != -1)
+    {
+      pos = 0;
+      while (nbytes > pos)
+	{
+#ifdef HAVE_PREAD
+	  bytes = pread (m_local_fd.get (), (gdb_byte *) buf + pos,
+			 nbytes - pos, offset + pos);
+#else
+	  bytes = -1;
+#endif
+	  /* If we have no pread or it failed for this file, use
+	     lseek/read.  */
+	  if (bytes == -1)
+	    {
+	      bytes = lseek (m_local_fd.get (), offset + pos, SEEK_SET);
+	      if (bytes != -1)
+		bytes = ::read (m_local_fd.get (), (gdb_byte *) buf + pos,
+				nbytes - pos);
+	    }
+	  if (bytes == 0)
+	    /* Success, but no bytes, means end-of-file.  */
+	    break;
+	  if (bytes == -1)
+	    {
+	      bfd_set_error (bfd_error_system_call);
+	      return -1;
+	    }
+
+	  pos += bytes;
+	}
+
+      return pos;
+    }
+
   pos = 0;
   while (nbytes > pos)
     {
@@ -493,6 +540,26 @@ target_fileio_stream::stat (struct bfd *abfd, struct stat *sb)
   return result;
 }
 
+void
+target_fileio_stream::use_target_file_cache (bfd *abfd)
+{
+  /* The build ID is read through the target, but that only needs the
+     headers and the notes.  */
+  if (!bfd_check_format (abfd, bfd_object))
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_get (abfd);
+  if (build_id == nullptr)
+    return;
+
+  struct stat st;
+  if (stat (abfd, &st) != 0)
+    return;
+
+  m_local_fd = target_file_cache_open (bfd_get_filename (abfd), m_fd,
+				       build_id, st.st_size);
+}
+
 /* A helper function to initialize the data that gdb attaches to each
    BFD.  */
 
@@ -529,13 +596,18 @@ gdb_bfd_open (const char *name, const char *target, int fd,
 	{
 	  gdb_assert (fd == -1);
 
+	  target_fileio_stream *stream = nullptr;
 	  auto open = [&] (bfd *nbfd) -> gdb_bfd_iovec_base *
 	  {
-	    return gdb_bfd_iovec_fileio_open (nbfd, current_inferior (),
-					      warn_if_slow);
+	    stream = gdb_bfd_iovec_fileio_open (nbfd, current_inferior (),
+						warn_if_slow);
+	    return stream;
 	  };
 
-	  return gdb_bfd_openr_iovec (name, target, open);
+	  gdb_bfd_ref_ptr result = gdb_bfd_openr_iovec (name, target, open);
+	  if (result != nullptr && target_file_cache_enabled_p ())
+	    stream->use_target_file_cache (result.get ());
+	  return result;
 	}
 
       name += strlen (TARGET_SYSROOT_PREFIX);
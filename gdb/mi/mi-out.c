@@ -21,6 +21,7 @@
 
 #include "mi-out.h"
 
+#include <array>
 #include <vector>
 
 #include "interps.h"
@@ -99,8 +100,7 @@ mi_ui_out::do_field_signed (int fldno, int width, ui_align alignment,
 			    const char *fldname, LONGEST value,
 			    const ui_file_style &style)
 {
-  do_field_string (fldno, width, alignment, fldname, plongest (value),
-		   style);
+  write_field (fldname, plongest (value), false);
 }
 
 /* Output an unsigned field.  */
@@ -109,8 +109,7 @@ void
 mi_ui_out::do_field_unsigned (int fldno, int width, ui_align alignment,
 			      const char *fldname, ULONGEST value)
 {
-  do_field_string (fldno, width, alignment, fldname, pulongest (value),
-		   ui_file_style ());
+  write_field (fldname, pulongest (value), false);
 }
 
 /* Used to omit a field.  */
@@ -129,15 +128,7 @@ mi_ui_out::do_field_string (int fldno, int width, ui_align align,
 			    const char *fldname, const char *string,
 			    const ui_file_style &style)
 {
-  ui_file *stream = m_streams.back ();
-  field_separator ();
-
-  if (fldname)
-    gdb_printf (stream, "%s=", fldname);
-  gdb_printf (stream, "\"");
-  if (string)
-    stream->putstr (string, '"');
-  gdb_printf (stream, "\"");
+  write_field (fldname, string, true);
 }
 
 void
@@ -146,14 +137,9 @@ mi_ui_out::do_field_fmt (int fldno, int width, ui_align align,
 			 const char *format, va_list args)
 {
   ui_file *stream = m_streams.back ();
-  field_separator ();
-
-  if (fldname)
-    gdb_printf (stream, "%s=\"", fldname);
-  else
-    gdb_puts ("\"", stream);
+  start_field (fldname, '"');
   gdb_vprintf (stream, format, args);
-  gdb_puts ("\"", stream);
+  stream->write ("\"", 1);
 }
 
 void
@@ -195,39 +181,107 @@ mi_ui_out::do_redirect (ui_file *outstream)
     m_streams.pop_back ();
 }
 
+/* Tables of the characters which ui_file::putstr escapes inside a
+   string quoted with '"', indexed by the value of sevenbit_strings.  */
+
+static const std::array<std::array<bool, 256>, 2> mi_escaped_chars = [] ()
+{
+  std::array<std::array<bool, 256>, 2> tables {};
+
+  for (int sevenbit = 0; sevenbit < 2; ++sevenbit)
+    for (int c = 0; c < 256; ++c)
+      tables[sevenbit][c] = (c < 0x20
+			     || (c >= 0x7f && c < 0xa0)
+			     || (sevenbit && c >= 0x80)
+			     || c == '\\' || c == '"');
+  return tables;
+} ();
+
+/* Write STRING to STREAM, escaped as the contents of an MI c-string.
+   The runs of characters which need no escaping, usually the whole
+   string, are written with a single call.  */
+
+static void
+mi_write_escaped (ui_file *stream, const char *string)
+{
+  const std::array<bool, 256> &escaped = mi_escaped_chars[sevenbit_strings];
+  const char *run = string;
+  const char *p = string;
+
+  for (; *p != '\0'; ++p)
+    if (escaped[(unsigned char) *p])
+      {
+	if (p > run)
+	  stream->write (run, p - run);
+	stream->putstrn (p, 1, '"');
+	run = p + 1;
+      }
+
+  if (p > run)
+    stream->write (run, p - run);
+}
+
+/* Write the separator from the previous field if there is one, then
+   "NAME=" if NAME is not NULL, then OPENER.  */
+
 void
-mi_ui_out::field_separator ()
+mi_ui_out::start_field (const char *name, char opener)
 {
+  m_field_prefix.clear ();
+
   if (m_suppress_field_separator)
     m_suppress_field_separator = false;
   else
-    gdb_putc (',', m_streams.back ());
+    m_field_prefix += ',';
+
+  if (name != nullptr)
+    {
+      m_field_prefix += name;
+      m_field_prefix += '=';
+    }
+  m_field_prefix += opener;
+
+  m_streams.back ()->write (m_field_prefix.data (), m_field_prefix.size ());
 }
 
+/* Output a field named FLDNAME, whose value is STRING.  If ESCAPE is
+   false, STRING is known not to need escaping.  */
+
 void
-mi_ui_out::open (const char *name, ui_out_type type)
+mi_ui_out::write_field (const char *fldname, const char *string,
+			bool escape)
 {
   ui_file *stream = m_streams.back ();
 
-  field_separator ();
-  m_suppress_field_separator = true;
-
-  if (name)
-    gdb_printf (stream, "%s=", name);
+  start_field (fldname, '"');
+  if (string != nullptr)
+    {
+      if (escape)
+	mi_write_escaped (stream, string);
+      else
+	stream->puts (string);
+    }
+  stream->write ("\"", 1);
+}
 
+void
+mi_ui_out::open (const char *name, ui_out_type type)
+{
   switch (type)
     {
     case ui_out_type_tuple:
-      gdb_putc ('{', stream);
+      start_field (name, '{');
       break;
 
     case ui_out_type_list:
-      gdb_putc ('[', stream);
+      start_field (name, '[');
       break;
 
     default:
       internal_error (_("bad switch"));
     }
+
+  m_suppress_field_separator = true;
 }
 
 void
@@ -97,7 +97,8 @@ class mi_ui_out : public ui_out
 
 private:
 
-  void field_separator ();
+  void start_field (const char *name, char opener);
+  void write_field (const char *fldname, const char *string, bool escape);
   void open (const char *name, ui_out_type type);
   void close (ui_out_type type);
 
@@ -142,6 +143,10 @@ class mi_ui_out : public ui_out
   bool m_suppress_field_separator;
   int m_mi_version;
   std::vector<ui_file *> m_streams;
+
+  /* The text start_field writes before a field or a list or tuple,
+     kept here so that its buffer is reused.  */
+  std::string m_field_prefix;
 };
 
 /* Create an MI ui-out object with MI version MI_VERSION, which should be equal
@@ -22,6 +22,7 @@
 #include "ui-out.h"
 #include "source.h"
 #include "mi-getopt.h"
+#include "observable.h"
 
 /* Print the list of all pc addresses and lines of code for the
    provided (full or base) source file name.  The entries are sorted
@@ -105,68 +106,167 @@ output_nondebug_symbol (ui_out *uiout, const bound_minimal_symbol &msymbol)
   uiout->field_string ("name", msymbol.minsym->print_name ());
 }
 
+/* The complete results of the last search made by one of the
+   -symbol-info-* commands given the --from option, kept so that the
+   following pages of results are output without searching again.  */
+
+struct mi_symbol_search_results
+{
+  /* The arguments of the search.  */
+  domain_search_flags kind;
+  std::optional<std::string> name_regexp;
+  std::optional<std::string> type_regexp;
+  bool exclude_minsyms;
+  program_space *pspace;
+
+  /* The sorted results.  */
+  std::vector<symbol_search> symbols;
+};
+
+static std::optional<mi_symbol_search_results> last_symbol_search;
+
+/* Return REGEXP as an optional string.  */
+
+static std::optional<std::string>
+regexp_to_optional (const char *regexp)
+{
+  if (regexp == nullptr)
+    return {};
+  return std::string (regexp);
+}
+
+/* Return all the symbols matching KIND, NAME_REGEXP, TYPE_REGEXP, and
+   EXCLUDE_MINSYMS, reusing the results of the previous search if it
+   had the same arguments.  */
+
+static const std::vector<symbol_search> &
+mi_symbol_search_all (domain_search_flags kind, const char *name_regexp,
+		      const char *type_regexp, bool exclude_minsyms)
+{
+  if (last_symbol_search.has_value ()
+      && last_symbol_search->kind == kind
+      && last_symbol_search->name_regexp == regexp_to_optional (name_regexp)
+      && last_symbol_search->type_regexp == regexp_to_optional (type_regexp)
+      && last_symbol_search->exclude_minsyms == exclude_minsyms
+      && last_symbol_search->pspace == current_program_space)
+    return last_symbol_search->symbols;
+
+  last_symbol_search.reset ();
+
+  global_symbol_searcher sym_search (kind, name_regexp);
+  sym_search.set_symbol_type_regexp (type_regexp);
+  sym_search.set_exclude_minsyms (exclude_minsyms);
+  std::vector<symbol_search> symbols = sym_search.search ();
+
+  last_symbol_search.emplace ();
+  last_symbol_search->kind = kind;
+  last_symbol_search->name_regexp = regexp_to_optional (name_regexp);
+  last_symbol_search->type_regexp = regexp_to_optional (type_regexp);
+  last_symbol_search->exclude_minsyms = exclude_minsyms;
+  last_symbol_search->pspace = current_program_space;
+  last_symbol_search->symbols = std::move (symbols);
+  return last_symbol_search->symbols;
+}
+
 /* This is the guts of the commands '-symbol-info-functions',
    '-symbol-info-variables', and '-symbol-info-types'.  It searches for
    symbols matching KING, NAME_REGEXP, TYPE_REGEXP, and EXCLUDE_MINSYMS,
-   and then prints the matching [m]symbols in an MI structured format.  */
+   and then prints the matching [m]symbols in an MI structured format.
+
+   If FROM is set, only the MAX_RESULTS results starting at index FROM
+   of the complete, sorted, results are printed, followed by the index
+   of the next page of results if there is one.  Otherwise, the search
+   stops after finding MAX_RESULTS results.  */
 
 static void
 mi_symbol_info (domain_search_flags kind, const char *name_regexp,
 		const char *type_regexp, bool exclude_minsyms,
-		size_t max_results)
+		size_t max_results, std::optional<size_t> from)
 {
-  global_symbol_searcher sym_search (kind, name_regexp);
-  sym_search.set_symbol_type_regexp (type_regexp);
-  sym_search.set_exclude_minsyms (exclude_minsyms);
-  sym_search.set_max_search_results (max_results);
-  std::vector<symbol_search> symbols = sym_search.search ();
-  ui_out *uiout = current_uiout;
-  int i = 0;
+  std::vector<symbol_search> found;
+  gdb::array_view<const symbol_search> symbols;
+  size_t next = 0;
 
-  ui_out_emit_tuple outer_symbols_emitter (uiout, "symbols");
+  /* An empty page would either claim that there are no results, or
+     point a frontend following NEXT back to the same page.  */
+  if (from.has_value () && max_results == 0)
+    error (_("--max-results must not be 0 with --from"));
 
-  /* Debug symbols are placed first. */
-  if (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
+  if (from.has_value ())
     {
-      ui_out_emit_list debug_symbols_list_emitter (uiout, "debug");
-
-      /* As long as we have debug symbols...  */
-      while (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
-	{
-	  symtab *symtab = symbols[i].symbol->symtab ();
-	  ui_out_emit_tuple symtab_tuple_emitter (uiout, nullptr);
-
-	  uiout->field_string ("filename",
-			       symtab_to_filename_for_display (symtab));
-	  uiout->field_string ("fullname", symtab_to_fullname (symtab));
+      const std::vector<symbol_search> &all
+	= mi_symbol_search_all (kind, name_regexp, type_regexp,
+				exclude_minsyms);
+      size_t start = std::min (*from, all.size ());
+      size_t count = std::min (max_results, all.size () - start);
+
+      symbols = gdb::array_view<const symbol_search> (all).slice (start,
+								  count);
+      if (start + count < all.size ())
+	next = start + count;
+    }
+  else
+    {
+      global_symbol_searcher sym_search (kind, name_regexp);
+      sym_search.set_symbol_type_regexp (type_regexp);
+      sym_search.set_exclude_minsyms (exclude_minsyms);
+      sym_search.set_max_search_results (max_results);
+      found = sym_search.search ();
+      symbols = found;
+    }
 
-	  ui_out_emit_list symbols_list_emitter (uiout, "symbols");
+  ui_out *uiout = current_uiout;
+  int i = 0;
 
-	  /* As long as we have debug symbols from this symtab...  */
-	  for (; (i < symbols.size ()
-		  && symbols[i].msymbol.minsym == nullptr
-		  && symbols[i].symbol->symtab () == symtab);
-	       ++i)
-	    {
-	      symbol_search &s = symbols[i];
+  {
+    ui_out_emit_tuple outer_symbols_emitter (uiout, "symbols");
 
-	      output_debug_symbol (uiout, kind, s.symbol, s.block);
-	    }
-	}
-    }
+    /* Debug symbols are placed first. */
+    if (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
+      {
+	ui_out_emit_list debug_symbols_list_emitter (uiout, "debug");
+
+	/* As long as we have debug symbols...  */
+	while (i < symbols.size () && symbols[i].msymbol.minsym == nullptr)
+	  {
+	    symtab *symtab = symbols[i].symbol->symtab ();
+	    ui_out_emit_tuple symtab_tuple_emitter (uiout, nullptr);
+
+	    uiout->field_string ("filename",
+				 symtab_to_filename_for_display (symtab));
+	    uiout->field_string ("fullname", symtab_to_fullname (symtab));
+
+	    ui_out_emit_list symbols_list_emitter (uiout, "symbols");
+
+	    /* As long as we have debug symbols from this symtab...  */
+	    for (; (i < symbols.size ()
+		    && symbols[i].msymbol.minsym == nullptr
+		    && symbols[i].symbol->symtab () == symtab);
+		 ++i)
+	      {
+		const symbol_search &s = symbols[i];
+
+		output_debug_symbol (uiout, kind, s.symbol, s.block);
+	      }
+	  }
+      }
 
-  /* Non-debug symbols are placed after.  */
-  if (i < symbols.size ())
-    {
-      ui_out_emit_list nondebug_symbols_list_emitter (uiout, "nondebug");
+    /* Non-debug symbols are placed after.  */
+    if (i < symbols.size ())
+      {
+	ui_out_emit_list nondebug_symbols_list_emitter (uiout, "nondebug");
+
+	/* As long as we have nondebug symbols...  */
+	for (; i < symbols.size (); i++)
+	  {
+	    gdb_assert (symbols[i].msymbol.minsym != nullptr);
+	    output_nondebug_symbol (uiout, symbols[i].msymbol);
+	  }
+      }
+  }
 
-      /* As long as we have nondebug symbols...  */
-      for (; i < symbols.size (); i++)
-	{
-	  gdb_assert (symbols[i].msymbol.minsym != nullptr);
-	  output_nondebug_symbol (uiout, symbols[i].msymbol);
-	}
-    }
+  if (next != 0)
+    uiout->field_unsigned ("next", next);
 }
 
 /* Helper to parse the option text from an -max-results argument and return
@@ -184,6 +284,20 @@ parse_max_results_option (const char *arg)
   return max_results;
 }
 
+/* Helper to parse the option text from a --from argument and return the
+   parsed value.  If the text can't be parsed then an error is thrown.  */
+
+static size_t
+parse_from_option (const char *arg)
+{
+  char *ptr;
+  long long val = strtoll (arg, &ptr, 10);
+  if (arg == ptr || *ptr != '\0' || val > SIZE_MAX || val < 0)
+    error (_("invalid value for --from argument"));
+
+  return (size_t) val;
+}
+
 /* Helper for mi_cmd_symbol_info_{functions,variables} - depending on KIND.
    Processes command line options from ARGV and ARGC.  */
 
@@ -192,13 +306,15 @@ mi_info_functions_or_variables (domain_search_flags kind,
 				const char *const *argv, int argc)
 {
   size_t max_results = SIZE_MAX;
+  std::optional<size_t> from;
   const char *regexp = nullptr;
   const char *t_regexp = nullptr;
   bool exclude_minsyms = true;
 
   enum opt
     {
-     INCLUDE_NONDEBUG_OPT, TYPE_REGEXP_OPT, NAME_REGEXP_OPT, MAX_RESULTS_OPT
+     INCLUDE_NONDEBUG_OPT, TYPE_REGEXP_OPT, NAME_REGEXP_OPT, MAX_RESULTS_OPT,
+     FROM_OPT
     };
   static const struct mi_opt opts[] =
   {
@@ -206,6 +322,7 @@ mi_info_functions_or_variables (domain_search_flags kind,
     {"-type", TYPE_REGEXP_OPT, 1},
     {"-name", NAME_REGEXP_OPT, 1},
     {"-max-results", MAX_RESULTS_OPT, 1},
+    {"-from", FROM_OPT, 1},
     { 0, 0, 0 }
   };
 
@@ -234,10 +351,14 @@ mi_info_functions_or_variables (domain_search_flags kind,
 	case MAX_RESULTS_OPT:
 	  max_results = parse_max_results_option (oarg);
 	  break;
+	case FROM_OPT:
+	  from = parse_from_option (oarg);
+	  break;
 	}
     }
 
-  mi_symbol_info (kind, regexp, t_regexp, exclude_minsyms, max_results);
+  mi_symbol_info (kind, regexp, t_regexp, exclude_minsyms, max_results,
+		  from);
 }
 
 /* Type for an iterator over a vector of module_symbol_search results.  */
@@ -411,16 +532,18 @@ mi_cmd_symbol_info_modules (const char *command, const char *const *argv,
 			    int argc)
 {
   size_t max_results = SIZE_MAX;
+  std::optional<size_t> from;
   const char *regexp = nullptr;
 
   enum opt
     {
-     NAME_REGEXP_OPT, MAX_RESULTS_OPT
+     NAME_REGEXP_OPT, MAX_RESULTS_OPT, FROM_OPT
     };
   static const struct mi_opt opts[] =
   {
     {"-name", NAME_REGEXP_OPT, 1},
     {"-max-results", MAX_RESULTS_OPT, 1},
+    {"-from", FROM_OPT, 1},
     { 0, 0, 0 }
   };
 
@@ -441,10 +564,14 @@ mi_cmd_symbol_info_modules (const char *command, const char *const *argv,
 	case MAX_RESULTS_OPT:
 	  max_results = parse_max_results_option (oarg);
 	  break;
+	case FROM_OPT:
+	  from = parse_from_option (oarg);
+	  break;
 	}
     }
 
-  mi_symbol_info (SEARCH_MODULE_DOMAIN, regexp, nullptr, true, max_results);
+  mi_symbol_info (SEARCH_MODULE_DOMAIN, regexp, nullptr, true, max_results,
+		  from);
 }
 
 /* Implement -symbol-info-types command.  */
@@ -454,16 +581,18 @@ mi_cmd_symbol_info_types (const char *command, const char *const *argv,
 			  int argc)
 {
   size_t max_results = SIZE_MAX;
+  std::optional<size_t> from;
   const char *regexp = nullptr;
 
   enum opt
     {
-     NAME_REGEXP_OPT, MAX_RESULTS_OPT
+     NAME_REGEXP_OPT, MAX_RESULTS_OPT, FROM_OPT
     };
   static const struct mi_opt opts[] =
   {
     {"-name", NAME_REGEXP_OPT, 1},
     {"-max-results", MAX_RESULTS_OPT, 1},
+    {"-from", FROM_OPT, 1},
     { 0, 0, 0 }
   };
 
@@ -484,11 +613,14 @@ mi_cmd_symbol_info_types (const char *command, const char *const *argv,
 	case MAX_RESULTS_OPT:
 	  max_results = parse_max_results_option (oarg);
 	  break;
+	case FROM_OPT:
+	  from = parse_from_option (oarg);
+	  break;
 	}
     }
 
   mi_symbol_info (SEARCH_TYPE_DOMAIN | SEARCH_STRUCT_DOMAIN, regexp, nullptr,
-		  true, max_results);
+		  true, max_results, from);
 }
 
 /* Implement -symbol-info-variables command.  */
@@ -499,3 +631,25 @@ mi_cmd_symbol_info_variables (const char *command, const char *const *argv,
 {
   mi_info_functions_or_variables (SEARCH_VAR_DOMAIN, argv, argc);
 }
+
+/* Forget the results of the last paged symbol search, which may refer
+   to symbols of objfiles that are gone, or miss new ones.  */
+
+static void
+mi_symbol_search_results_invalidate ()
+{
+  last_symbol_search.reset ();
+}
+
+INIT_GDB_FILE (mi_symbol_cmds)
+{
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *) { mi_symbol_search_results_invalidate (); },
+     "mi-symbol-cmds");
+  gdb::observers::free_objfile.attach
+    ([] (struct objfile *) { mi_symbol_search_results_invalidate (); },
+     "mi-symbol-cmds");
+  gdb::observers::all_objfiles_removed.attach
+    ([] (program_space *) { mi_symbol_search_results_invalidate (); },
+     "mi-symbol-cmds");
+}
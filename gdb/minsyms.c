@@ -47,6 +47,7 @@
 #include "cp-abi.h"
 #include "target.h"
 #include "cp-support.h"
+#include "demangle-cache.h"
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "gdbsupport/symbol.h"
@@ -543,6 +544,140 @@ iterate_over_minimal_symbols
     }
 }
 
+/* Return true if the names of minimal symbols in language LANG can
+   only match a completion at a name component boundary, as delimited
+   by "::" or ".".  */
+
+static bool
+msymbol_completion_indexable_language (enum language lang)
+{
+  switch (lang)
+    {
+    case language_c:
+    case language_objc:
+    case language_cplus:
+    case language_d:
+    case language_go:
+    case language_rust:
+    case language_asm:
+    case language_opencl:
+    case language_minimal:
+    /* The language of most minimal symbols without debug info is not
+       known; their names are matched like C names.  */
+    case language_unknown:
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+/* Build the completion index of the minimal symbols of OBJF.  */
+
+static std::unique_ptr<msymbol_completion_index>
+build_msymbol_completion_index (struct objfile *objf)
+{
+  auto index = std::make_unique<msymbol_completion_index> ();
+
+  for (minimal_symbol *msymbol : objf->msymbols ())
+    {
+      const char *name = msymbol->natural_name ();
+
+      /* Objective-C method names are also matched on their
+	 selectors.  */
+      if (!msymbol_completion_indexable_language (msymbol->language ())
+	  || name[0] == '-' || name[0] == '+')
+	{
+	  index->unindexed.push_back (msymbol);
+	  continue;
+	}
+
+      index->entries.push_back ({ name, msymbol });
+      for (const char *p = name; *p != '\0'; ++p)
+	{
+	  if (p[0] == ':' && p[1] == ':')
+	    {
+	      ++p;
+	      index->entries.push_back ({ p + 1, msymbol });
+	    }
+	  else if (p[0] == '.')
+	    index->entries.push_back ({ p + 1, msymbol });
+	}
+    }
+
+  std::sort (index->entries.begin (), index->entries.end (),
+	     [] (const msymbol_completion_index::entry &a,
+		 const msymbol_completion_index::entry &b)
+	     {
+	       return strcmp (a.suffix, b.suffix) < 0;
+	     });
+  index->entries.shrink_to_fit ();
+
+  return index;
+}
+
+/* See minsyms.h.  */
+
+void
+iterate_over_minimal_symbols_for_completion
+    (struct objfile *objf, const lookup_name_info &lookup_name,
+     gdb::function_view<void (struct minimal_symbol *)> callback)
+{
+  /* Use the leading identifier characters of the text being completed
+     as the prefix to look up.  A leading "::" denotes the global
+     scope, and anything after the identifier, such as whitespace or a
+     template argument list, is left to the symbol name matcher.  */
+  std::string_view text = lookup_name.name ();
+  while (!text.empty () && text[0] == ':')
+    text.remove_prefix (1);
+
+  size_t len = 0;
+  while (len < text.size ()
+	 && (c_isalnum (text[len]) || text[len] == '_' || text[len] == '$'
+	     || text[len] == '~' || text[len] == ':' || text[len] == '.'))
+    ++len;
+  std::string_view prefix = text.substr (0, len);
+
+  /* Without a prefix, or when matching ignores case, the index can't
+     narrow down the search.  */
+  if (prefix.empty () || case_sensitivity != case_sensitive_on)
+    {
+      for (minimal_symbol *msymbol : objf->msymbols ())
+	callback (msymbol);
+      return;
+    }
+
+  std::unique_ptr<msymbol_completion_index> &index
+    = objf->per_bfd->msymbol_completion;
+  if (index == nullptr)
+    index = build_msymbol_completion_index (objf);
+
+  auto begin = std::lower_bound (index->entries.begin (),
+				 index->entries.end (), prefix,
+				 [] (const msymbol_completion_index::entry &e,
+				     std::string_view pfx)
+				 {
+				   return e.suffix < pfx;
+				 });
+
+  /* A symbol can be found through several of its components.  */
+  std::vector<minimal_symbol *> candidates;
+  for (auto it = begin;
+       it != index->entries.end () && startswith (it->suffix, prefix);
+       ++it)
+    candidates.push_back (it->msymbol);
+
+  std::sort (candidates.begin (), candidates.end ());
+  candidates.erase (std::unique (candidates.begin (), candidates.end ()),
+		    candidates.end ());
+
+  for (minimal_symbol *msymbol : candidates)
+    callback (msymbol);
+
+  for (minimal_symbol *msymbol : index->unindexed)
+    callback (msymbol);
+}
+
 /* See minsyms.h.  */
 
 bound_minimal_symbol
@@ -1464,6 +1599,7 @@ minimal_symbol_reader::install ()
 
       if (m_objfile->per_bfd->minimal_symbol_count != 0)
 	clear_minimal_symbol_hash_tables (m_objfile);
+      m_objfile->per_bfd->msymbol_completion.reset ();
 
       m_objfile->per_bfd->minimal_symbol_count = mcount;
       m_objfile->per_bfd->msymbols = std::move (msym_holder);
@@ -1476,6 +1612,10 @@ minimal_symbol_reader::install ()
 
       msymbols = m_objfile->per_bfd->msymbols.get ();
 
+      /* Let the workers reuse the names demangled for this objfile by an
+	 earlier session.  */
+      demangle_cache_load_objfile (m_objfile);
+
       gdb::parallel_for_each<1000, minimal_symbol *, minimal_symbol_install_worker>
 	(&msymbols[0], &msymbols[mcount], msymbols,
 	 gdb::array_view<computed_hash_values> (hash_values),
@@ -1483,6 +1623,8 @@ minimal_symbol_reader::install ()
 	 demangled_mutex);
 
       build_minimal_symbol_hash_tables (m_objfile, hash_values);
+
+      demangle_cache_save_objfile (m_objfile);
     }
 }
 
@@ -289,6 +289,16 @@ bound_minimal_symbol lookup_minimal_symbol_by_pc_section
 
 bound_minimal_symbol lookup_minimal_symbol_by_pc (CORE_ADDR);
 
+/* Call CALLBACK for each minimal symbol in the objfile OBJF that may
+   match LOOKUP_NAME when completing, in no particular order.  This
+   uses an index of the symbol names, so CALLBACK may be called for
+   far fewer symbols than there are, but it still must check the match
+   itself.  */
+
+void iterate_over_minimal_symbols_for_completion
+    (struct objfile *objf, const lookup_name_info &lookup_name,
+     gdb::function_view<void (struct minimal_symbol *)> callback);
+
 /* Iterate over all the minimal symbols in the objfile OBJF which
    match NAME.  Both the ordinary and demangled names of each symbol
    are considered.  The caller is responsible for canonicalizing NAME,
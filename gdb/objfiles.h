@@ -207,6 +207,31 @@ struct minimal_symbol_iterator
   struct minimal_symbol *m_msym;
 };
 
+/* An index of the names of the minimal symbols of an objfile, used to
+   find completion candidates without looking at every symbol.  See
+   iterate_over_minimal_symbols_for_completion.  */
+
+struct msymbol_completion_index
+{
+  struct entry
+  {
+    /* The part of the natural name of MSYMBOL that starts at a name
+       component boundary, e.g. "bar::baz" and "baz" for
+       "foo::bar::baz".  */
+    const char *suffix;
+
+    minimal_symbol *msymbol;
+  };
+
+  /* The entries, sorted by SUFFIX.  */
+  std::vector<entry> entries;
+
+  /* The minimal symbols whose names can match a completion other than
+     at a component boundary, e.g. because of case-insensitive or
+     language-specific matching.  */
+  std::vector<minimal_symbol *> unindexed;
+};
+
 /* Some objfile data is hung off the BFD.  This enables sharing of the
    data across all objfiles using the BFD.  The data is stored in an
    instance of this structure, and associated with the BFD using the
@@ -322,6 +347,9 @@ struct objfile_per_bfd_storage
      hash table.  */
   std::bitset<nr_languages> demangled_hash_languages;
 
+  /* The completion index of the minimal symbols, built on first use.  */
+  std::unique_ptr<msymbol_completion_index> msymbol_completion;
+
 private:
   /* The BFD this object is associated to.  */
 
@@ -25,11 +25,24 @@ class _FrameDecoratorBase(object):
     # class.
     def __init__(self, base):
         self._base = base
+        # The frame whose limitedness was last computed, and the answer,
+        # as set by __is_limited_frame.
+        self.__limited = None
 
-    @staticmethod
-    def __is_limited_frame(frame):
+    def __is_limited_frame(self, frame):
         """Internal utility to determine if the frame is special or
         limited."""
+        # Several methods need this, and finding the sal can be
+        # costly, so remember the answer for the frame.
+        if self.__limited is not None and self.__limited[0] == frame:
+            return self.__limited[1]
+
+        limited = self.__compute_limited_frame(frame)
+        self.__limited = (frame, limited)
+        return limited
+
+    @staticmethod
+    def __compute_limited_frame(frame):
         sal = frame.find_sal()
 
         if (
@@ -26,6 +26,7 @@ class FrameIterator(object):
 
         super(FrameIterator, self).__init__()
         self.frame = frame_obj
+        self._returned_frame = False
 
     def __iter__(self):
         return self
@@ -36,8 +37,13 @@ class FrameIterator(object):
         Returns:
             The next oldest frame."""
 
+        # Only unwind to the older frame when it is asked for, so that
+        # a consumer that stops early, like "bt 10", does not unwind
+        # one frame more than it uses.
+        if self._returned_frame and self.frame is not None:
+            self.frame = self.frame.older()
         result = self.frame
         if result is None:
             raise StopIteration
-        self.frame = result.older()
+        self._returned_frame = True
         return result
@@ -36,6 +36,7 @@ from _gdb import (
     STDOUT,
     Color,
     Command,
+    Objfile,
     Parameter,
     Style,
     execute,
@@ -106,11 +107,68 @@ frame_unwinders = []
 missing_file_handlers = []
 
 
+def _all_unwinders():
+    """Return an iterator over the unwinders of the current program space.
+
+    Objfile unwinders come first, then program space unwinders, then
+    global unwinders, which is the order GDB tries them in."""
+    for objfile in objfiles():
+        yield from objfile.frame_unwinders
+    yield from current_progspace().frame_unwinders
+    yield from frame_unwinders
+
+
+def _unwinder_applies(unwinder, pc):
+    """Return True if UNWINDER may claim a frame whose PC is PC."""
+    pc_ranges = getattr(unwinder, "pc_ranges", None)
+    if pc_ranges is None:
+        return True
+    objfile = None
+    for pc_range in pc_ranges:
+        if isinstance(pc_range, Objfile):
+            if objfile is None:
+                objfile = current_progspace().objfile_for_address(pc)
+            if objfile is not None and pc_range == objfile:
+                return True
+        else:
+            start, end = pc_range
+            if start <= pc < end:
+                return True
+    return False
+
+
+def _unwinder_pc_ranges():
+    """Internal function called from GDB to find which PCs need unwinders.
+
+    Returns:
+        None, if some enabled unwinder may claim a frame at any PC.
+        Otherwise, a list of (start, end) tuples and gdb.Objfile
+        objects, covering the PCs of the frames the enabled unwinders
+        may claim.
+    """
+    ranges = []
+    for unwinder in _all_unwinders():
+        if not unwinder.enabled:
+            continue
+        pc_ranges = getattr(unwinder, "pc_ranges", None)
+        if pc_ranges is None:
+            return None
+        for pc_range in pc_ranges:
+            if isinstance(pc_range, Objfile):
+                if pc_range.is_valid():
+                    ranges.append(pc_range)
+            else:
+                start, end = pc_range
+                ranges.append((int(start), int(end)))
+    return ranges
+
+
 def _execute_unwinders(pending_frame):
     """Internal function called from GDB to execute all unwinders.
 
     Runs each currently enabled unwinder until it finds the one that
-    can unwind given frame.
+    can unwind given frame.  Unwinders whose PC ranges do not include
+    the frame's PC are skipped.
 
     Arguments:
         pending_frame: gdb.PendingFrame instance.
@@ -123,24 +181,18 @@ def _execute_unwinders(pending_frame):
 
         or None, if no unwinder has claimed the frame.
     """
-    for objfile in objfiles():
-        for unwinder in objfile.frame_unwinders:
-            if unwinder.enabled:
-                unwind_info = unwinder(pending_frame)
-                if unwind_info is not None:
-                    return (unwind_info, unwinder.name)
-
-    for unwinder in current_progspace().frame_unwinders:
-        if unwinder.enabled:
-            unwind_info = unwinder(pending_frame)
-            if unwind_info is not None:
-                return (unwind_info, unwinder.name)
-
-    for unwinder in frame_unwinders:
-        if unwinder.enabled:
-            unwind_info = unwinder(pending_frame)
-            if unwind_info is not None:
-                return (unwind_info, unwinder.name)
+    pc = None
+    for unwinder in _all_unwinders():
+        if not unwinder.enabled:
+            continue
+        if getattr(unwinder, "pc_ranges", None) is not None:
+            if pc is None:
+                pc = pending_frame.pc()
+            if not _unwinder_applies(unwinder, pc):
+                continue
+        unwind_info = unwinder(pending_frame)
+        if unwind_info is not None:
+            return (unwind_info, unwinder.name)
 
     return None
 
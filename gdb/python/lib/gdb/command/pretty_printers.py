@@ -323,6 +323,10 @@ def do_enable_pretty_printer(arg, flag):
                 objfile.pretty_printers, name_re, subname_re, flag
             )
 
+    # Printers that do not derive from the gdb.printing classes do not
+    # report changes to their 'enabled' attribute.
+    gdb.invalidate_cached_pretty_printers()
+
     if flag:
         state = "enabled"
     else:
@@ -50,6 +50,16 @@ class PrettyPrinter(object):
         self.subprinters = subprinters
         self.enabled = True
 
+    @property
+    def enabled(self):
+        return self._enabled
+
+    @enabled.setter
+    def enabled(self, value):
+        self._enabled = value
+        # GDB remembers which printer handles each type.
+        gdb.invalidate_cached_pretty_printers()
+
     def __call__(self, val):
         # The subclass must define this.
         raise NotImplementedError("PrettyPrinter __call__")
@@ -69,6 +79,16 @@ class SubPrettyPrinter(object):
         self.name = name
         self.enabled = True
 
+    @property
+    def enabled(self):
+        return self._enabled
+
+    @enabled.setter
+    def enabled(self, value):
+        self._enabled = value
+        # GDB remembers which printer handles each type.
+        gdb.invalidate_cached_pretty_printers()
+
 
 def register_pretty_printer(obj, printer, replace=False):
     """Register pretty-printer PRINTER with OBJ.
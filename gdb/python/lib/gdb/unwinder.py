@@ -27,13 +27,20 @@ class Unwinder(object):
     Attributes:
         name: The name of the unwinder.
         enabled: A boolean indicating whether the unwinder is enabled.
+        pc_ranges: None, or a tuple of the PC ranges of the frames the
+            unwinder may claim.  Each element is either a (start, end)
+            tuple, or a gdb.Objfile standing for its code sections.
+            The ranges are changed by assigning a new sequence, so that
+            GDB notices the change.
     """
 
-    def __init__(self, name):
+    def __init__(self, name, pc_ranges=None):
         """Constructor.
 
         Args:
             name: An identifying name for the unwinder.
+            pc_ranges: The PC ranges of the frames the unwinder may
+                claim, or None if it may claim any frame.
         """
 
         if not isinstance(name, str):
@@ -41,6 +48,7 @@ class Unwinder(object):
 
         self._name = name
         self._enabled = True
+        self._pc_ranges = None if pc_ranges is None else tuple(pc_ranges)
 
     @property
     def name(self):
@@ -57,6 +65,15 @@ class Unwinder(object):
         self._enabled = value
         gdb.invalidate_cached_frames()
 
+    @property
+    def pc_ranges(self):
+        return self._pc_ranges
+
+    @pc_ranges.setter
+    def pc_ranges(self, value):
+        self._pc_ranges = None if value is None else tuple(value)
+        gdb.invalidate_cached_frames()
+
     def __call__(self, pending_frame):
         """GDB calls this method to unwind a frame.
 
@@ -454,17 +454,28 @@ enumerate_args (PyObject *iter,
       if (success == EXT_LANG_BT_ERROR)
 	return EXT_LANG_BT_ERROR;
 
-      success = extract_value (item.get (), &val);
-      if (success == EXT_LANG_BT_ERROR)
-	return EXT_LANG_BT_ERROR;
-
       if (sym && out->is_mi_like_p ()
 	  && ! mi_should_print (sym, MI_PRINT_ARGS))
 	continue;
 
+      /* When values are not printed, only the name of the argument
+	 is shown, so don't fetch the value at all.  This is what
+	 print_frame_args does too.  */
+      if (args_type == NO_VALUES)
+	val = NULL;
+      else
+	{
+	  success = extract_value (item.get (), &val);
+	  if (success == EXT_LANG_BT_ERROR)
+	    return EXT_LANG_BT_ERROR;
+	}
+
+      if (args_type == NO_VALUES)
+	py_print_single_arg (out, sym_name.get (), NULL, NULL, &opts,
+			     args_type, print_args_field, language);
       /* If the object did not provide a value, read it using
 	 read_frame_args and account for entry values, if any.  */
-      if (val == NULL)
+      else if (val == NULL)
 	{
 	  struct frame_arg arg, entryarg;
 
@@ -574,17 +585,24 @@ enumerate_locals (PyObject *iter,
       if (success == EXT_LANG_BT_ERROR)
 	return EXT_LANG_BT_ERROR;
 
-      success = extract_value (item.get (), &val);
-      if (success == EXT_LANG_BT_ERROR)
-	return EXT_LANG_BT_ERROR;
-
       if (sym != NULL && out->is_mi_like_p ()
 	  && ! mi_should_print (sym, MI_PRINT_LOCALS))
 	continue;
 
-      /* If the object did not provide a value, read it.  */
-      if (val == NULL)
-	val = read_var_value (sym, sym_block, frame);
+      /* MI without values only shows the name of the variable, so
+	 don't fetch the value at all.  */
+      bool print_value = !out->is_mi_like_p () || args_type != NO_VALUES;
+      val = NULL;
+      if (print_value)
+	{
+	  success = extract_value (item.get (), &val);
+	  if (success == EXT_LANG_BT_ERROR)
+	    return EXT_LANG_BT_ERROR;
+
+	  /* If the object did not provide a value, read it.  */
+	  if (val == NULL)
+	    val = read_var_value (sym, sym_block, frame);
+	}
 
       /* With PRINT_NO_VALUES, MI does not emit a tuple normally as
 	 each output contains only one field.  The exception is
@@ -276,6 +276,7 @@ objfpy_set_printers (PyObject *o, PyObject *value, void *ignore)
   gdbpy_ref<> tmp (self->printers);
   Py_INCREF (value);
   self->printers = value;
+  gdbpy_invalidate_pretty_printer_cache ();
 
   return 0;
 }
@@ -693,6 +694,17 @@ objfile_to_objfile_object (struct objfile *objfile)
   return gdbpy_ref<>::new_reference (result);
 }
 
+/* Return the objfile wrapped by OBJ, or NULL if OBJ is not a
+   gdb.Objfile, or is no longer valid.  */
+
+struct objfile *
+objfile_object_to_objfile (PyObject *obj)
+{
+  if (!PyObject_TypeCheck (obj, &objfile_object_type))
+    return NULL;
+  return ((objfile_object *) obj)->objfile;
+}
+
 static int
 gdbpy_initialize_objfile ()
 {
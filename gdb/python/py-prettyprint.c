@@ -25,9 +25,16 @@
 #include "python.h"
 #include "python-internal.h"
 #include "cli/cli-style.h"
+#include "observable.h"
+#include "progspace.h"
+#include "gdbsupport/unordered_map.h"
+#include "cp-builtin-printers.h"
 
 extern PyTypeObject printer_object_type;
 
+static gdbpy_ref<> make_builtin_printer
+  (std::unique_ptr<builtin_libstdcxx_container> container);
+
 /* Return type of print_string_repr.  */
 
 enum gdbpy_string_repr_result
@@ -44,14 +51,31 @@ enum gdbpy_string_repr_result
    printing.  */
 const struct value_print_options *gdbpy_current_print_options;
 
+/* Return 1 if the lookup function FUNCTION is enabled, 0 if its
+   "enabled" attribute is false.  On error, set the Python error and
+   return -1.  */
+
+static int
+pp_function_enabled (PyObject *function)
+{
+  if (!PyObject_HasAttr (function, gdbpy_enabled_cst))
+    return 1;
+
+  gdbpy_ref<> attr (PyObject_GetAttr (function, gdbpy_enabled_cst));
+  if (attr == NULL)
+    return -1;
+  return PyObject_IsTrue (attr.get ());
+}
+
 /* Helper function for find_pretty_printer which iterates over a list,
    calls each function and inspects output.  This will return a
-   printer object if one recognizes VALUE.  If no printer is found, it
-   will return None.  On error, it will set the Python error and
-   return NULL.  */
+   printer object if one recognizes VALUE, and set *FOUND_FUNCTION to
+   a new reference to the function that returned it.  If no printer is
+   found, it will return None.  On error, it will set the Python error
+   and return NULL.  */
 
 static gdbpy_ref<>
-search_pp_list (PyObject *list, PyObject *value)
+search_pp_list (PyObject *list, PyObject *value, gdbpy_ref<> *found_function)
 {
   Py_ssize_t pp_list_size, list_index;
 
@@ -63,27 +87,21 @@ search_pp_list (PyObject *list, PyObject *value)
 	return NULL;
 
       /* Skip if disabled.  */
-      if (PyObject_HasAttr (function, gdbpy_enabled_cst))
-	{
-	  gdbpy_ref<> attr (PyObject_GetAttr (function, gdbpy_enabled_cst));
-	  int cmp;
-
-	  if (attr == NULL)
-	    return NULL;
-	  cmp = PyObject_IsTrue (attr.get ());
-	  if (cmp == -1)
-	    return NULL;
-
-	  if (!cmp)
-	    continue;
-	}
+      int enabled = pp_function_enabled (function);
+      if (enabled == -1)
+	return NULL;
+      if (!enabled)
+	continue;
 
       gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function, value,
 							 NULL));
       if (printer == NULL)
 	return NULL;
       else if (printer != Py_None)
-	return printer;
+	{
+	  *found_function = gdbpy_ref<>::new_reference (function);
+	  return printer;
+	}
     }
 
   return gdbpy_ref<>::new_reference (Py_None);
@@ -93,10 +111,11 @@ search_pp_list (PyObject *list, PyObject *value)
    Look for a pretty-printer to print VALUE in all objfiles.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Otherwise the result is the pretty-printer function, suitably inc-ref'd,
+   and *FUNCTION is set to the lookup function that returned it.  */
 
 static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+find_pretty_printer_from_objfiles (PyObject *value, gdbpy_ref<> *function)
 {
   for (objfile &obj : current_program_space->objfiles ())
     {
@@ -109,14 +128,14 @@ find_pretty_printer_from_objfiles (PyObject *value)
 	}
 
       gdbpy_ref<> pp_list (objfpy_get_printers (objf.get (), NULL));
-      gdbpy_ref<> function (search_pp_list (pp_list.get (), value));
+      gdbpy_ref<> printer (search_pp_list (pp_list.get (), value, function));
 
       /* If there is an error in any objfile list, abort the search and exit.  */
-      if (function == NULL)
+      if (printer == NULL)
 	return NULL;
 
-      if (function != Py_None)
-	return function.release ();
+      if (printer != Py_None)
+	return printer.release ();
     }
 
   Py_RETURN_NONE;
@@ -126,27 +145,29 @@ find_pretty_printer_from_objfiles (PyObject *value)
    Look for a pretty-printer to print VALUE in the current program space.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Otherwise the result is the pretty-printer function, suitably inc-ref'd,
+   and *FUNCTION is set to the lookup function that returned it.  */
 
 static gdbpy_ref<>
-find_pretty_printer_from_progspace (PyObject *value)
+find_pretty_printer_from_progspace (PyObject *value, gdbpy_ref<> *function)
 {
   gdbpy_ref<> obj = pspace_to_pspace_object (current_program_space);
 
   if (obj == NULL)
     return NULL;
   gdbpy_ref<> pp_list (pspy_get_printers (obj.get (), NULL));
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, function);
 }
 
 /* Subroutine of find_pretty_printer to simplify it.
    Look for a pretty-printer to print VALUE in the gdb module.
    The result is NULL if there's an error and the search should be terminated.
    The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Otherwise the result is the pretty-printer function, suitably inc-ref'd,
+   and *FUNCTION is set to the lookup function that returned it.  */
 
 static gdbpy_ref<>
-find_pretty_printer_from_gdb (PyObject *value)
+find_pretty_printer_from_gdb (PyObject *value, gdbpy_ref<> *function)
 {
   /* Fetch the global pretty printer list.  */
   if (gdb_python_module == NULL
@@ -157,29 +178,243 @@ find_pretty_printer_from_gdb (PyObject *value)
   if (pp_list == NULL || ! PyList_Check (pp_list.get ()))
     return gdbpy_ref<>::new_reference (Py_None);
 
-  return search_pp_list (pp_list.get (), value);
+  return search_pp_list (pp_list.get (), value, function);
 }
 
-/* Find the pretty-printing constructor function for VALUE.  If no
-   pretty-printer exists, return None.  If one exists, return a new
-   reference.  On error, set the Python error and return NULL.  */
+/* Search all the pretty-printer lists for a printer for VALUE.  The
+   result is as for find_pretty_printer.  If a printer is found,
+   *FUNCTION is set to the lookup function that returned it.  */
 
 static gdbpy_ref<>
-find_pretty_printer (PyObject *value)
+search_pretty_printers (PyObject *value, gdbpy_ref<> *function)
 {
   /* Look at the pretty-printer list for each objfile
      in the current program-space.  */
-  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value));
-  if (function == NULL || function != Py_None)
-    return function;
+  gdbpy_ref<> printer (find_pretty_printer_from_objfiles (value, function));
+  if (printer == NULL || printer != Py_None)
+    return printer;
 
   /* Look at the pretty-printer list for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
-  if (function == NULL || function != Py_None)
-    return function;
+  printer = find_pretty_printer_from_progspace (value, function);
+  if (printer == NULL || printer != Py_None)
+    return printer;
 
   /* Look at the pretty-printer list in the gdb module.  */
-  return find_pretty_printer_from_gdb (value);
+  return find_pretty_printer_from_gdb (value, function);
+}
+
+/* Lookup functions generally choose a printer from the type of the
+   value alone, yet searching the lists means calling, in Python, every
+   lookup function ahead of the one that matches, for every value
+   printed, including each element of a container.  To avoid this, the
+   lookup function found for each type, or the fact that there is
+   none, is remembered.  The cache applies to the current program
+   space.  It is flushed when its generation is no longer current, and
+   when a printer list was replaced or changed length since the cache
+   was filled.  The generation changes when objfiles come and go, when
+   a pretty_printers attribute is assigned, when a printer derived from
+   the gdb.printing classes is enabled or disabled, and when
+   gdb.invalidate_cached_pretty_printers is called.  */
+
+/* The lookup function that returned a printer for values of each type,
+   or NULL if no lookup function recognized the type.  */
+
+static gdb::unordered_map<struct type *, gdbpy_ref<>> pretty_printer_cache;
+
+/* The program space the entries of pretty_printer_cache apply to.  */
+
+static program_space *pretty_printer_cache_pspace;
+
+/* The current generation of the pretty-printer lists.  */
+
+static unsigned long pretty_printer_generation;
+
+/* The generation pretty_printer_cache was filled in.  Flushing the
+   cache may release Python objects, so the cache is only flushed when
+   it is next used, with the Python lock held.  */
+
+static unsigned long pretty_printer_cache_generation;
+
+/* A pretty-printer list, and its length, when pretty_printer_cache was
+   filled.  */
+
+struct pp_list_state
+{
+  gdbpy_ref<> list;
+  Py_ssize_t size;
+};
+
+/* The pretty-printer lists searched when pretty_printer_cache was
+   filled, in search order.  */
+
+static std::vector<pp_list_state> pretty_printer_cache_lists;
+
+/* Call CALLBACK for each pretty-printer list searched for a printer,
+   in order.  Stop and return false if CALLBACK returns false.  */
+
+static bool
+for_each_pp_list (gdb::function_view<bool (PyObject *list)> callback)
+{
+  for (objfile &obj : current_program_space->objfiles ())
+    {
+      gdbpy_ref<> objf = objfile_to_objfile_object (&obj);
+      if (objf == NULL)
+	{
+	  /* As for find_pretty_printer_from_objfiles.  */
+	  PyErr_Clear ();
+	  continue;
+	}
+
+      gdbpy_ref<> pp_list (objfpy_get_printers (objf.get (), NULL));
+      if (!callback (pp_list.get ()))
+	return false;
+    }
+
+  gdbpy_ref<> obj = pspace_to_pspace_object (current_program_space);
+  if (obj == NULL)
+    return false;
+  gdbpy_ref<> pp_list (pspy_get_printers (obj.get (), NULL));
+  if (!callback (pp_list.get ()))
+    return false;
+
+  if (gdb_python_module != NULL
+      && PyObject_HasAttrString (gdb_python_module, "pretty_printers"))
+    {
+      pp_list.reset (PyObject_GetAttrString (gdb_python_module,
+					     "pretty_printers"));
+      if (pp_list == NULL)
+	return false;
+      if (PyList_Check (pp_list.get ()) && !callback (pp_list.get ()))
+	return false;
+    }
+
+  return true;
+}
+
+/* Record the current pretty-printer lists in
+   pretty_printer_cache_lists.  Return false on error.  */
+
+static bool
+record_pp_lists ()
+{
+  pretty_printer_cache_lists.clear ();
+
+  return for_each_pp_list ([] (PyObject *list)
+    {
+      pretty_printer_cache_lists.push_back
+	({ gdbpy_ref<>::new_reference (list), PyList_Size (list) });
+      return true;
+    });
+}
+
+/* Return true if the pretty-printer lists are the ones recorded in
+   pretty_printer_cache_lists, with the same lengths.  */
+
+static bool
+pp_lists_unchanged ()
+{
+  size_t index = 0;
+  bool ok = for_each_pp_list ([&] (PyObject *list)
+    {
+      if (index >= pretty_printer_cache_lists.size ())
+	return false;
+
+      const pp_list_state &state = pretty_printer_cache_lists[index++];
+      return state.list.get () == list && PyList_Size (list) == state.size;
+    });
+
+  /* A failure is reported by the search that follows.  */
+  if (PyErr_Occurred ())
+    PyErr_Clear ();
+
+  return ok && index == pretty_printer_cache_lists.size ();
+}
+
+/* See python-internal.h.  */
+
+void
+gdbpy_invalidate_pretty_printer_cache ()
+{
+  ++pretty_printer_generation;
+}
+
+/* Implementation of gdb.invalidate_cached_pretty_printers.  */
+
+PyObject *
+gdbpy_invalidate_cached_pretty_printers (PyObject *self, PyObject *args)
+{
+  gdbpy_invalidate_pretty_printer_cache ();
+  Py_RETURN_NONE;
+}
+
+/* Return true if the entries of pretty_printer_cache are current.  */
+
+static bool
+pretty_printer_cache_current_p ()
+{
+  return (pretty_printer_cache_generation == pretty_printer_generation
+	  && pretty_printer_cache_pspace == current_program_space
+	  && pp_lists_unchanged ());
+}
+
+/* Find the pretty-printing constructor function for VALUE.  If no
+   pretty-printer exists, return None.  If one exists, return a new
+   reference.  On error, set the Python error and return NULL.  */
+
+static gdbpy_ref<>
+find_pretty_printer (PyObject *value)
+{
+  bool cacheable = true;
+  if (!pretty_printer_cache_current_p ())
+    {
+      pretty_printer_cache.clear ();
+      pretty_printer_cache_pspace = current_program_space;
+      pretty_printer_cache_generation = pretty_printer_generation;
+      if (!record_pp_lists ())
+	{
+	  PyErr_Clear ();
+	  pretty_printer_cache_lists.clear ();
+	  cacheable = false;
+	}
+    }
+
+  struct type *type = value_object_to_value (value)->type ();
+  auto it = pretty_printer_cache.find (type);
+  if (it != pretty_printer_cache.end ())
+    {
+      if (it->second == nullptr)
+	return gdbpy_ref<>::new_reference (Py_None);
+
+      /* Keep the function alive while calling it, in case it changes
+	 the printer lists.  */
+      gdbpy_ref<> function = it->second;
+      int enabled = pp_function_enabled (function.get ());
+      if (enabled == -1)
+	return nullptr;
+      if (enabled)
+	{
+	  gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function.get (),
+							     value, nullptr));
+	  if (printer == nullptr || printer != Py_None)
+	    return printer;
+	}
+
+      /* The lookup function was disabled, or looked at more than the
+	 type of this value.  Fall back to searching the lists.  */
+    }
+
+  gdbpy_ref<> function;
+  gdbpy_ref<> printer = search_pretty_printers (value, &function);
+  if (printer == nullptr)
+    return printer;
+
+  /* The lookup functions may have changed the printer lists, or
+     printed a value of their own.  Only record a result that is known
+     to be current.  */
+  if (cacheable && pretty_printer_cache_current_p ())
+    pretty_printer_cache[type] = std::move (function);
+
+  return printer;
 }
 
 /* Pretty-print a single value, via the printer object PRINTER.
@@ -352,223 +587,341 @@ print_string_repr (PyObject *printer, const char *hint,
   return result;
 }
 
-/* Helper for gdbpy_apply_val_pretty_printer that formats children of the
-   printer, if any exist.  If is_py_none is true, then nothing has
-   been printed by to_string, and format output accordingly. */
-static void
-print_children (PyObject *printer, const char *hint,
-		struct ui_file *stream, int recurse,
-		const struct value_print_options *options,
-		const struct language_defn *language,
-		int is_py_none)
+/* The number of bytes of array elements that gdbpy_array_children
+   reads from memory at once.  */
+
+#define GDBPY_ARRAY_CHILDREN_BATCH_BYTES (64 * 1024)
+
+/* Return the array of children of PRINTER, as returned by its
+   children_array method.  HINT is PRINTER's display hint, or NULL.
+   Return NULL if PRINTER does not provide its children this way.  On
+   error, set the Python error and return NULL.  */
+
+struct value *
+gdbpy_get_children_array (PyObject *printer, const char *hint)
 {
-  int is_map, is_array, done_flag, pretty;
-  unsigned int i;
+  /* The children of a map alternate between keys and values, so they
+     can't be the elements of a single array.  */
+  if (hint != nullptr && strcmp (hint, "map") == 0)
+    return nullptr;
 
-  if (! PyObject_HasAttr (printer, gdbpy_children_cst))
-    return;
+  /* This is not a basic method, so only printers derived from
+     gdb.ValuePrinter are asked.  */
+  if (!PyObject_TypeCheck (printer, &printer_object_type)
+      || !PyObject_HasAttr (printer, gdbpy_children_array_cst))
+    return nullptr;
 
-  /* If we are printing a map or an array, we want some special
-     formatting.  */
-  is_map = hint && ! strcmp (hint, "map");
-  is_array = hint && ! strcmp (hint, "array");
+  gdbpy_ref<> result (PyObject_CallMethodObjArgs (printer,
+						  gdbpy_children_array_cst,
+						  nullptr));
+  if (result == nullptr || result == Py_None)
+    return nullptr;
 
-  gdbpy_ref<> children (PyObject_CallMethodObjArgs (printer, gdbpy_children_cst,
-						    NULL));
-  if (children == NULL)
-    {
-      print_stack_unless_memory_error (stream);
-      return;
-    }
+  struct value *array = convert_value_from_python (result.get ());
+  if (array == nullptr)
+    return nullptr;
 
-  gdbpy_ref<> iter (PyObject_GetIter (children.get ()));
-  if (iter == NULL)
+  if (check_typedef (array->type ())->code () != TYPE_CODE_ARRAY)
     {
-      print_stack_unless_memory_error (stream);
-      return;
+      PyErr_SetString (PyExc_TypeError,
+		       _("Result of children_array is not an array."));
+      return nullptr;
     }
 
-  /* Use the prettyformat_arrays option if we are printing an array,
-     and the pretty option otherwise.  */
-  if (is_array)
-    pretty = options->prettyformat_arrays;
-  else
-    {
-      if (options->prettyformat == Val_prettyformat)
-	pretty = 1;
-      else
-	pretty = options->prettyformat_structs;
-    }
+  return array;
+}
 
-  done_flag = 0;
-  for (i = 0; i < options->print_max; ++i)
-    {
-      PyObject *py_v;
-      const char *name;
+gdbpy_array_children::gdbpy_array_children (struct value *array)
+  : m_array (release_value (array))
+{
+  struct type *type = check_typedef (array->type ());
+  LONGEST high;
 
-      gdbpy_ref<> item (PyIter_Next (iter.get ()));
-      if (item == NULL)
-	{
-	  if (PyErr_Occurred ())
-	    print_stack_unless_memory_error (stream);
-	  /* Set a flag so we can know whether we printed all the
-	     available elements.  */
-	  else
-	    done_flag = 1;
-	  break;
-	}
+  if (get_discrete_bounds (type->index_type (), &m_low, &high))
+    m_size = std::max<LONGEST> (high - m_low + 1, 0);
 
-      if (! PyTuple_Check (item.get ()) || PyTuple_Size (item.get ()) != 2)
-	{
-	  PyErr_SetString (PyExc_TypeError,
-			   _("Result of children iterator not a tuple"
-			     " of two elements."));
-	  gdbpy_print_stack ();
-	  continue;
-	}
-      if (! PyArg_ParseTuple (item.get (), "sO", &name, &py_v))
-	{
-	  /* The user won't necessarily get a stack trace here, so provide
-	     more context.  */
-	  if (gdbpy_print_python_errors_p ())
-	    gdb_printf (gdb_stderr,
-			_("Bad result from children iterator.\n"));
-	  gdbpy_print_stack ();
-	  continue;
-	}
+  ULONGEST elt_len = check_typedef (type->target_type ())->length ();
+  if (elt_len > 0)
+    m_batch_size = std::max<ULONGEST> (GDBPY_ARRAY_CHILDREN_BATCH_BYTES
+				       / elt_len, 1);
+}
+
+/* See python-internal.h.  */
+
+std::string
+gdbpy_array_children::name (LONGEST n) const
+{
+  return string_printf ("[%s]", plongest (m_low + n));
+}
+
+/* See python-internal.h.  */
 
-      /* Print initial "=" to separate print_string_repr output and
-	 children.  For other elements, there are three cases:
-	 1. Maps.  Print a "," after each value element.
-	 2. Arrays.  Always print a ",".
-	 3. Other.  Always print a ",".  */
-      if (i == 0)
+struct value *
+gdbpy_array_children::child (LONGEST n)
+{
+  gdb_assert (n >= 0 && n < m_size);
+
+  /* Children are usually accessed in order, so read the elements
+     following N along with it, rather than each on its own.  A value
+     that is not in memory is already all there.  */
+  if (m_array->lval () != lval_memory || !m_array->lazy ())
+    return value_subscript (m_array.get (), m_low + n);
+
+  if (n >= m_unreadable_start && n < m_unreadable_end)
+    return value_subscript (m_array.get (), m_low + n);
+
+  if (m_batch == nullptr
+      || n < m_batch_start || n >= m_batch_start + m_batch_size)
+    {
+      LONGEST length = std::min (m_batch_size, m_size - n);
+      value_ref_ptr batch
+	= release_value (value_slice (m_array.get (), m_low + n, length));
+      try
 	{
-	  if (!is_py_none)
-	    gdb_puts (" = ", stream);
+	  batch->fetch_lazy ();
 	}
-      else if (! is_map || i % 2 == 0)
-	gdb_puts (pretty ? "," : ", ", stream);
-
-      /* Skip printing children if max_depth has been reached.  This check
-	 is performed after print_string_repr and the "=" separator so that
-	 these steps are not skipped if the variable is located within the
-	 permitted depth.  */
-      if (val_print_check_max_depth (stream, recurse, options, language))
-	return;
-      else if (i == 0)
-	/* Print initial "{" to bookend children.  */
-	gdb_puts ("{", stream);
-
-      /* In summary mode, we just want to print "= {...}" if there is
-	 a value.  */
-      if (options->summary)
+      catch (const gdb_exception_error &except)
 	{
-	  /* This increment tricks the post-loop logic to print what
-	     we want.  */
-	  ++i;
-	  /* Likewise.  */
-	  pretty = 0;
-	  break;
+	  /* Some of these elements can't be read.  Leave each of them
+	     to be read on its own, so that the error is reported for
+	     the right element.  */
+	  m_unreadable_start = n;
+	  m_unreadable_end = n + length;
+	  return value_subscript (m_array.get (), m_low + n);
 	}
 
-      if (! is_map || i % 2 == 0)
-	{
-	  if (pretty)
-	    {
-	      gdb_puts ("\n", stream);
-	      print_spaces (2 + 2 * recurse, stream);
-	    }
-	  else
-	    stream->wrap_here (2 + 2 *recurse);
-	}
+      m_batch = std::move (batch);
+      m_batch_start = n;
+    }
+
+  return value_subscript (m_batch.get (), m_low + n);
+}
+
+/* The children of a Python pretty-printer, as returned either by its
+   children_array method or by its children method.  */
+
+class python_children : public pretty_children
+{
+public:
+
+  /* Return the children of PRINTER, whose display hint is HINT, which
+     are printed to STREAM.  If PRINTER has no children, or on error,
+     return an empty optional; the error is left to be reported by the
+     caller.  */
+  static std::optional<python_children> get (PyObject *printer,
+					     const char *hint,
+					     struct ui_file *stream);
+
+  pretty_child_status fetch (unsigned int n) override;
+
+  const char *name () override
+  {
+    return m_name;
+  }
+
+  void print (struct ui_file *stream, int recurse,
+	      const struct value_print_options *options,
+	      const struct language_defn *language) override;
+
+private:
+
+  /* Where errors fetching the children are reported.  */
+  struct ui_file *m_stream = nullptr;
+
+  /* The children, from the children_array method, if the printer
+     provided it.  */
+  std::optional<gdbpy_array_children> m_array_children;
+
+  /* Otherwise, the iterator over the children.  */
+  gdbpy_ref<> m_iter;
+
+  /* The child fetched last.  Its value is M_ARRAY_CHILD if it comes
+     from M_ARRAY_CHILDREN, or M_PY_V otherwise, which is owned by
+     M_ITEM, as is M_NAME.  */
+  gdbpy_ref<> m_item;
+  std::string m_array_child_name;
+  const char *m_name = nullptr;
+  struct value *m_array_child = nullptr;
+  PyObject *m_py_v = nullptr;
+};
+
+std::optional<python_children>
+python_children::get (PyObject *printer, const char *hint,
+		      struct ui_file *stream)
+{
+  std::optional<python_children> result;
+
+  struct value *array = gdbpy_get_children_array (printer, hint);
+  if (array != nullptr)
+    {
+      result.emplace ();
+      result->m_stream = stream;
+      result->m_array_children.emplace (array);
+      return result;
+    }
+  else if (PyErr_Occurred ())
+    return result;
 
-      if (is_map && i % 2 == 0)
-	gdb_puts ("[", stream);
-      else if (is_array)
+  if (! PyObject_HasAttr (printer, gdbpy_children_cst))
+    return result;
+
+  gdbpy_ref<> children (PyObject_CallMethodObjArgs (printer,
+						    gdbpy_children_cst,
+						    NULL));
+  if (children == NULL)
+    return result;
+
+  gdbpy_ref<> iter (PyObject_GetIter (children.get ()));
+  if (iter == NULL)
+    return result;
+
+  result.emplace ();
+  result->m_stream = stream;
+  result->m_iter = std::move (iter);
+  return result;
+}
+
+pretty_child_status
+python_children::fetch (unsigned int n)
+{
+  if (m_array_children.has_value ())
+    {
+      if (n >= m_array_children->size ())
+	return pretty_child_status::END;
+
+      /* As for the children iterator, a memory error is reported and
+	 ends the children.  */
+      try
 	{
-	  /* We print the index, not whatever the child method
-	     returned as the name.  */
-	  if (options->print_array_indexes)
-	    gdb_printf (stream, "[%d] = ", i);
+	  m_array_child = m_array_children->child (n);
+	  if (m_array_child->lazy ())
+	    m_array_child->fetch_lazy ();
 	}
-      else if (! is_map)
+      catch (const gdb_exception_error &except)
 	{
-	  gdb_puts (name, stream);
-	  gdb_puts (" = ", stream);
+	  if (except.error != MEMORY_ERROR)
+	    throw;
+	  fprintf_styled (m_stream, metadata_style.style (),
+			  _("<error reading variable: %s>"), except.what ());
+	  return pretty_child_status::STOP;
 	}
 
-      if (gdbpy_is_lazy_string (py_v))
+      m_py_v = nullptr;
+      m_array_child_name = m_array_children->name (n);
+      m_name = m_array_child_name.c_str ();
+      return pretty_child_status::CHILD;
+    }
+
+  m_item.reset (PyIter_Next (m_iter.get ()));
+  if (m_item == NULL)
+    {
+      if (PyErr_Occurred ())
 	{
-	  CORE_ADDR addr;
-	  struct type *type;
-	  long length;
-	  gdb::unique_xmalloc_ptr<char> encoding;
-	  struct value_print_options local_opts = *options;
+	  print_stack_unless_memory_error (m_stream);
+	  return pretty_child_status::STOP;
+	}
+      return pretty_child_status::END;
+    }
 
-	  gdbpy_extract_lazy_string (py_v, &addr, &type, &length, &encoding);
+  if (! PyTuple_Check (m_item.get ())
+      || PyTuple_Size (m_item.get ()) != 2)
+    {
+      PyErr_SetString (PyExc_TypeError,
+		       _("Result of children iterator not a tuple"
+			 " of two elements."));
+      gdbpy_print_stack ();
+      return pretty_child_status::SKIP;
+    }
+  if (! PyArg_ParseTuple (m_item.get (), "sO", &m_name, &m_py_v))
+    {
+      /* The user won't necessarily get a stack trace here, so
+	 provide more context.  */
+      if (gdbpy_print_python_errors_p ())
+	gdb_printf (gdb_stderr,
+		    _("Bad result from children iterator.\n"));
+      gdbpy_print_stack ();
+      return pretty_child_status::SKIP;
+    }
 
-	  local_opts.addressprint = false;
-	  val_print_string (type, encoding.get (), addr, (int) length, stream,
-			    &local_opts);
-	}
-      else if (gdbpy_is_string (py_v))
-	{
-	  gdb::unique_xmalloc_ptr<char> output;
+  return pretty_child_status::CHILD;
+}
 
-	  output = python_string_to_host_string (py_v);
-	  if (!output)
-	    gdbpy_print_stack ();
-	  else
-	    gdb_puts (output.get (), stream);
-	}
-      else
-	{
-	  struct value *value = convert_value_from_python (py_v);
+void
+python_children::print (struct ui_file *stream, int recurse,
+			const struct value_print_options *options,
+			const struct language_defn *language)
+{
+  if (m_py_v == nullptr)
+    common_val_print (m_array_child, stream, recurse, options, language);
+  else if (gdbpy_is_lazy_string (m_py_v))
+    {
+      CORE_ADDR addr;
+      struct type *type;
+      long length;
+      gdb::unique_xmalloc_ptr<char> encoding;
+      struct value_print_options local_opts = *options;
 
-	  if (value == NULL)
-	    {
-	      gdbpy_print_stack ();
-	      error (_("Error while executing Python code."));
-	    }
-	  else
-	    {
-	      /* When printing the key of a map we allow one additional
-		 level of depth.  This means the key will print before the
-		 value does.  */
-	      struct value_print_options opt = *options;
-	      if (is_map && i % 2 == 0
-		  && opt.max_depth != -1
-		  && opt.max_depth < INT_MAX)
-		++opt.max_depth;
-	      common_val_print (value, stream, recurse + 1, &opt, language);
-	    }
-	}
+      gdbpy_extract_lazy_string (m_py_v, &addr, &type, &length, &encoding);
 
-      if (is_map && i % 2 == 0)
-	gdb_puts ("] = ", stream);
+      local_opts.addressprint = false;
+      val_print_string (type, encoding.get (), addr, (int) length, stream,
+			&local_opts);
     }
+  else if (gdbpy_is_string (m_py_v))
+    {
+      gdb::unique_xmalloc_ptr<char> output;
 
-  if (i)
+      output = python_string_to_host_string (m_py_v);
+      if (!output)
+	gdbpy_print_stack ();
+      else
+	gdb_puts (output.get (), stream);
+    }
+  else
     {
-      if (!done_flag)
-	{
-	  if (pretty)
-	    {
-	      gdb_puts ("\n", stream);
-	      print_spaces (2 + 2 * recurse, stream);
-	    }
-	  gdb_puts ("...", stream);
-	}
-      if (pretty)
+      struct value *value = convert_value_from_python (m_py_v);
+
+      if (value == NULL)
 	{
-	  gdb_puts ("\n", stream);
-	  print_spaces (2 * recurse, stream);
+	  gdbpy_print_stack ();
+	  error (_("Error while executing Python code."));
 	}
-      gdb_puts ("}", stream);
+      else
+	common_val_print (value, stream, recurse, options, language);
     }
 }
 
+/* Helper for gdbpy_apply_val_pretty_printer that formats children of the
+   printer, if any exist.  If is_py_none is true, then nothing has
+   been printed by to_string, and format output accordingly. */
+static void
+print_children (PyObject *printer, const char *hint,
+		struct ui_file *stream, int recurse,
+		const struct value_print_options *options,
+		const struct language_defn *language,
+		int is_py_none)
+{
+  std::optional<python_children> children
+    = python_children::get (printer, hint, stream);
+  if (!children.has_value ())
+    {
+      if (PyErr_Occurred ())
+	print_stack_unless_memory_error (stream);
+      return;
+    }
+
+  /* If we are printing a map or an array, we want some special
+     formatting.  */
+  pretty_children_layout layout = pretty_children_layout::STRUCT;
+  if (hint != nullptr && strcmp (hint, "map") == 0)
+    layout = pretty_children_layout::MAP;
+  else if (hint != nullptr && strcmp (hint, "array") == 0)
+    layout = pretty_children_layout::ARRAY;
+
+  print_pretty_children (*children, layout, !is_py_none, stream, recurse,
+			 options, language);
+}
+
 enum ext_lang_rc
 gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
 				struct value *value,
@@ -663,6 +1016,13 @@ apply_varobj_pretty_printer (PyObject *printer_obj,
 gdbpy_ref<>
 gdbpy_get_varobj_pretty_printer (struct value *value)
 {
+  /* Containers printed by GDB's built-in printers also get their
+     children from them.  */
+  std::unique_ptr<builtin_libstdcxx_container> container
+    = get_builtin_libstdcxx_container (value);
+  if (container != nullptr)
+    return make_builtin_printer (std::move (container));
+
   gdbpy_ref<> val_obj = value_to_value_object (value);
   if (val_obj == NULL)
     return NULL;
@@ -827,12 +1187,163 @@ PyTypeObject printer_object_type =
   PyType_GenericNew,		  /* tp_new */
 };
 
+/* A printer for a libstdc++ container printed by GDB's built-in
+   printers, which is given to varobjs in place of the libstdc++ Python
+   printer.  Its children are listed by py_varobj_get_iterator without
+   calling into Python.  */
+struct builtin_printer_object : public printer_object
+{
+  /* The container, owned by this object.  */
+  builtin_libstdcxx_container *container;
+};
+
+/* Implement the to_string method of a built-in printer.  */
+
+static PyObject *
+builtin_printer_to_string (PyObject *self, PyObject *args)
+{
+  builtin_libstdcxx_container *container
+    = ((builtin_printer_object *) self)->container;
+
+  if (strcmp (container->hint, "string") == 0)
+    return gdbpy_create_lazy_string_object
+      (container->string_addr, container->string_length, nullptr,
+       lookup_pointer_type (container->char_type));
+
+  return host_string_to_python_string (container->summary.c_str ()).release ();
+}
+
+/* Implement the display_hint method of a built-in printer.  */
+
+static PyObject *
+builtin_printer_display_hint (PyObject *self, PyObject *args)
+{
+  builtin_libstdcxx_container *container
+    = ((builtin_printer_object *) self)->container;
+
+  return host_string_to_python_string (container->hint).release ();
+}
+
+/* Deallocate a built-in printer.  */
+
+static void
+builtin_printer_dealloc (PyObject *self)
+{
+  delete ((builtin_printer_object *) self)->container;
+  Py_TYPE (self)->tp_free (self);
+}
+
+static PyMethodDef builtin_printer_object_methods[] =
+{
+  { "to_string", builtin_printer_to_string, METH_NOARGS,
+    "to_string () -> String.\n\
+Return the summary of the container." },
+  { "display_hint", builtin_printer_display_hint, METH_NOARGS,
+    "display_hint () -> String.\n\
+Return the display hint of the container." },
+  {NULL}  /* Sentinel */
+};
+
+/* The type object of built-in printers.  */
+PyTypeObject builtin_printer_object_type =
+{
+  PyVarObject_HEAD_INIT (NULL, 0)
+  "gdb._BuiltinLibstdcxxPrinter", /*tp_name*/
+  sizeof (builtin_printer_object), /*tp_basicsize*/
+  0,				  /*tp_itemsize*/
+  builtin_printer_dealloc,	  /*tp_dealloc*/
+  0,				  /*tp_print*/
+  0,				  /*tp_getattr*/
+  0,				  /*tp_setattr*/
+  0,				  /*tp_compare*/
+  0,				  /*tp_repr*/
+  0,				  /*tp_as_number*/
+  0,				  /*tp_as_sequence*/
+  0,				  /*tp_as_mapping*/
+  0,				  /*tp_hash*/
+  0,				  /*tp_call*/
+  0,				  /*tp_str*/
+  0,				  /*tp_getattro*/
+  0,				  /*tp_setattro*/
+  0,				  /*tp_as_buffer*/
+  Py_TPFLAGS_DEFAULT,		  /*tp_flags*/
+  "GDB built-in libstdc++ printer object", /* tp_doc */
+  0,				  /* tp_traverse */
+  0,				  /* tp_clear */
+  0,				  /* tp_richcompare */
+  0,				  /* tp_weaklistoffset */
+  0,				  /* tp_iter */
+  0,				  /* tp_iternext */
+  builtin_printer_object_methods, /* tp_methods */
+  0,				  /* tp_members */
+  0,				  /* tp_getset */
+  &printer_object_type,		  /* tp_base */
+};
+
+/* Return a new built-in printer for CONTAINER, or NULL with the Python
+   error set.  */
+
+static gdbpy_ref<>
+make_builtin_printer (std::unique_ptr<builtin_libstdcxx_container> container)
+{
+  builtin_printer_object *printer
+    = PyObject_New (builtin_printer_object, &builtin_printer_object_type);
+  if (printer == nullptr)
+    return nullptr;
+
+  printer->container = container.release ();
+  return gdbpy_ref<> (printer);
+}
+
+/* See python-internal.h.  */
+
+builtin_libstdcxx_container *
+gdbpy_get_builtin_printer_container (PyObject *printer)
+{
+  if (!PyObject_TypeCheck (printer, &builtin_printer_object_type))
+    return nullptr;
+  return ((builtin_printer_object *) printer)->container;
+}
+
 /* Set up the ValuePrinter type.  */
 
 static int
 gdbpy_initialize_prettyprint ()
 {
-  return gdbpy_type_ready (&printer_object_type);
+  if (gdbpy_type_ready (&printer_object_type) < 0)
+    return -1;
+  return gdbpy_type_ready (&builtin_printer_object_type);
 }
 
-GDBPY_INITIALIZE_FILE (gdbpy_initialize_prettyprint);
+/* Release the pretty-printer cache before the Python interpreter is
+   finalized.  */
+
+static void
+gdbpy_finalize_prettyprint ()
+{
+  pretty_printer_cache.clear ();
+  pretty_printer_cache_lists.clear ();
+}
+
+GDBPY_INITIALIZE_FILE (gdbpy_initialize_prettyprint,
+		       gdbpy_finalize_prettyprint);
+
+/* Objfile observer, flushing the pretty-printer cache.  Types are
+   owned by objfiles, and objfiles come with their own printers.  */
+
+static void
+gdbpy_prettyprint_objfile_changed (struct objfile *objfile)
+{
+  gdbpy_invalidate_pretty_printer_cache ();
+}
+
+INIT_GDB_FILE (py_prettyprint)
+{
+  gdb::observers::new_objfile.attach (gdbpy_prettyprint_objfile_changed,
+				      "py-prettyprint");
+  gdb::observers::free_objfile.attach (gdbpy_prettyprint_objfile_changed,
+				       "py-prettyprint");
+  gdb::observers::all_objfiles_removed.attach
+    ([] (program_space *pspace) { gdbpy_invalidate_pretty_printer_cache (); },
+     "py-prettyprint");
+}
@@ -30,6 +30,10 @@
 #include "stack.h"
 #include "charset.h"
 #include "block.h"
+#include "inferior.h"
+#include "objfiles.h"
+#include "progspace.h"
+#include "gdbsupport/unordered_map.h"
 
 
 /* Debugging of Python unwinders.  */
@@ -833,23 +837,234 @@ frame_unwind_python::prev_register (const frame_info_ptr &this_frame,
   return frame_unwind_got_optimized (this_frame, regnum);
 }
 
-/* Frame sniffer dispatch.  */
+/* Python unwinders may declare the PCs of the frames they can claim,
+   through their "pc_ranges" attribute.  The union of the ranges of
+   all the enabled unwinders is kept here, so that the sniffer can
+   decline any other frame without entering Python.  */
 
-int
-frame_unwind_python::sniff (const frame_info_ptr &this_frame,
-			    void **cache_ptr) const
+struct pyuw_pc_filter
 {
-  PYUW_SCOPED_DEBUG_ENTER_EXIT;
+  /* Return true if some enabled unwinder may claim a frame at PC.  */
 
-  struct gdbarch *gdbarch = (struct gdbarch *) (this->unwind_data ());
-  cached_frame_info *cached_frame;
+  bool contains (CORE_ADDR pc) const
+  {
+    if (any_pc)
+      return true;
+
+    auto it = std::upper_bound (ranges.begin (), ranges.end (), pc,
+				[] (CORE_ADDR addr,
+				    const std::pair<CORE_ADDR, CORE_ADDR> &r)
+				{
+				  return addr < r.first;
+				});
+    return it != ranges.begin () && pc < std::prev (it)->second;
+  }
 
-  gdbpy_enter enter_py (gdbarch);
+  /* Whether the fields below are up to date.  */
+  bool valid = false;
 
-  pyuw_debug_printf ("frame=%d, sp=%s, pc=%s",
-		     frame_relative_level (this_frame),
-		     paddress (gdbarch, get_frame_sp (this_frame)),
-		     paddress (gdbarch, get_frame_pc (this_frame)));
+  /* The program space the ranges were computed for.  */
+  program_space *pspace = nullptr;
+
+  /* True if some enabled unwinder did not declare its PC ranges.  */
+  bool any_pc = true;
+
+  /* Sorted and disjoint [START, END) ranges.  Only meaningful if
+     ANY_PC is false.  */
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+};
+
+static pyuw_pc_filter pyuw_filter;
+
+/* Add the range described by ITEM, an element of the list returned by
+   gdb._unwinder_pc_ranges, to RANGES.  Return false and set a Python
+   error on failure.  */
+
+static bool
+pyuw_add_pc_range (PyObject *item,
+		   std::vector<std::pair<CORE_ADDR, CORE_ADDR>> &ranges)
+{
+  struct objfile *objfile = objfile_object_to_objfile (item);
+  if (objfile != nullptr)
+    {
+      for (obj_section &osect : objfile->sections ())
+	if ((osect.the_bfd_section->flags & SEC_CODE) != 0)
+	  ranges.emplace_back (osect.addr (), osect.endaddr ());
+      return true;
+    }
+
+  CORE_ADDR start, end;
+  if (!PyTuple_Check (item) || PyTuple_Size (item) != 2)
+    {
+      PyErr_SetString (PyExc_TypeError,
+		       _("Unwinder PC ranges must be (START, END) tuples "
+			 "or gdb.Objfile objects."));
+      return false;
+    }
+  if (get_addr_from_python (PyTuple_GetItem (item, 0), &start) < 0
+      || get_addr_from_python (PyTuple_GetItem (item, 1), &end) < 0)
+    return false;
+
+  if (start < end)
+    ranges.emplace_back (start, end);
+  return true;
+}
+
+/* Recompute PYUW_FILTER for the current program space, by calling
+   gdb._unwinder_pc_ranges.  The GIL must be held.  */
+
+static void
+pyuw_update_pc_filter ()
+{
+  pyuw_filter.valid = true;
+  pyuw_filter.pspace = current_program_space;
+  pyuw_filter.any_pc = true;
+  pyuw_filter.ranges.clear ();
+
+  if (gdb_python_module == nullptr
+      || !PyObject_HasAttrString (gdb_python_module, "_unwinder_pc_ranges"))
+    return;
+
+  gdbpy_ref<> result (gdbpy_call_method (gdb_python_module,
+					 "_unwinder_pc_ranges"));
+  if (result == nullptr)
+    {
+      gdbpy_print_stack ();
+      return;
+    }
+  if (result == Py_None)
+    return;
+
+  std::vector<std::pair<CORE_ADDR, CORE_ADDR>> ranges;
+  gdbpy_ref<> iter (PyObject_GetIter (result.get ()));
+  if (iter == nullptr)
+    {
+      gdbpy_print_stack ();
+      return;
+    }
+  while (true)
+    {
+      gdbpy_ref<> item (PyIter_Next (iter.get ()));
+      if (item == nullptr)
+	{
+	  if (PyErr_Occurred ())
+	    {
+	      gdbpy_print_stack ();
+	      return;
+	    }
+	  break;
+	}
+
+      if (!pyuw_add_pc_range (item.get (), ranges))
+	{
+	  gdbpy_print_stack ();
+	  return;
+	}
+    }
+
+  /* Sort and merge the ranges, so that lookups can bisect them.  */
+  std::sort (ranges.begin (), ranges.end ());
+  for (const auto &range : ranges)
+    {
+      if (!pyuw_filter.ranges.empty ()
+	  && range.first <= pyuw_filter.ranges.back ().second)
+	pyuw_filter.ranges.back ().second
+	  = std::max (pyuw_filter.ranges.back ().second, range.second);
+      else
+	pyuw_filter.ranges.push_back (range);
+    }
+  pyuw_filter.any_pc = false;
+}
+
+/* The Python unwinders are called again for the frames of a thread
+   each time the frame cache is flushed, e.g. when switching threads.
+   To avoid that, what they made of a frame is remembered, keyed by
+   the frame's PC and stack pointer, until the inferior resumes or
+   something else may change the outcome.  */
+
+struct pyuw_frame_key
+{
+  bool operator== (const pyuw_frame_key &other) const
+  {
+    return (inf == other.inf && gdbarch == other.gdbarch
+	    && pc == other.pc && sp == other.sp);
+  }
+
+  inferior *inf;
+  struct gdbarch *gdbarch;
+  CORE_ADDR pc;
+  CORE_ADDR sp;
+};
+
+struct pyuw_frame_key_hash
+{
+  std::size_t operator() (const pyuw_frame_key &key) const noexcept
+  {
+    std::size_t h = std::hash<CORE_ADDR> () (key.pc);
+    h = h * 31 + std::hash<CORE_ADDR> () (key.sp);
+    h = h * 31 + std::hash<inferior *> () (key.inf);
+    return h * 31 + std::hash<struct gdbarch *> () (key.gdbarch);
+  }
+};
+
+/* The outcome of running the Python unwinders on a frame.  */
+
+struct pyuw_frame_result
+{
+  /* Whether an unwinder claimed the frame.  If false, the fields
+     below are not used.  */
+  bool claimed = false;
+
+  /* The ID of the frame.  */
+  struct frame_id frame_id;
+
+  /* The registers saved by the frame.  */
+  std::vector<cached_reg_t> regs;
+};
+
+static gdb::unordered_map<pyuw_frame_key, pyuw_frame_result,
+			  pyuw_frame_key_hash> pyuw_result_cache;
+
+/* See python-internal.h.  */
+
+void
+gdbpy_invalidate_unwinder_caches ()
+{
+  pyuw_filter.valid = false;
+  pyuw_result_cache.clear ();
+}
+
+/* Return a new cached_frame_info for GDBARCH, holding the frame ID and
+   registers of RESULT.  */
+
+static cached_frame_info *
+pyuw_make_cached_frame (struct gdbarch *gdbarch,
+			const pyuw_frame_result &result)
+{
+  int reg_count = result.regs.size ();
+  cached_frame_info *cached_frame
+    = ((cached_frame_info *)
+       xmalloc (sizeof (*cached_frame)
+		+ reg_count * sizeof (cached_frame->reg[0])));
+  cached_frame->gdbarch = gdbarch;
+  cached_frame->frame_id = result.frame_id;
+  cached_frame->reg_count = reg_count;
+
+  for (int i = 0; i < reg_count; ++i)
+    new (&cached_frame->reg[i]) cached_reg_t (result.regs[i]);
+
+  return cached_frame;
+}
+
+/* Run the Python unwinders on THIS_FRAME, and return what they made of
+   it.  */
+
+static pyuw_frame_result
+pyuw_run_unwinders (struct gdbarch *gdbarch, const frame_info_ptr &this_frame)
+{
+  pyuw_frame_result result;
+
+  gdbpy_enter enter_py (gdbarch);
 
   /* Create PendingFrame instance to pass to sniffers.  */
   pending_frame_object *pfo = PyObject_New (pending_frame_object,
@@ -858,7 +1073,7 @@ frame_unwind_python::sniff (const frame_info_ptr &this_frame,
   if (pyo_pending_frame == NULL)
     {
       gdbpy_print_stack ();
-      return 0;
+      return result;
     }
   pfo->gdbarch = gdbarch;
   pfo->frame_info = nullptr;
@@ -873,14 +1088,14 @@ frame_unwind_python::sniff (const frame_info_ptr &this_frame,
 		       "Installation error: gdb._execute_unwinders function "
 		       "is missing");
       gdbpy_print_stack ();
-      return 0;
+      return result;
     }
   gdbpy_ref<> pyo_execute (PyObject_GetAttrString (gdb_python_module,
 						   "_execute_unwinders"));
   if (pyo_execute == nullptr)
     {
       gdbpy_print_stack ();
-      return 0;
+      return result;
     }
 
   /* A (gdb.UnwindInfo, str) tuple, or None.  */
@@ -892,10 +1107,10 @@ frame_unwind_python::sniff (const frame_info_ptr &this_frame,
       /* If the unwinder is cancelled due to a Ctrl-C, then propagate
 	 the Ctrl-C as a GDB exception instead of swallowing it.  */
       gdbpy_print_stack_or_quit ();
-      return 0;
+      return result;
     }
   if (pyo_execute_ret == Py_None)
-    return 0;
+    return result;
 
   /* Verify the return value of _execute_unwinders is a tuple of size 2.  */
   gdb_assert (PyTuple_Check (pyo_execute_ret.get ()));
@@ -926,41 +1141,93 @@ frame_unwind_python::sniff (const frame_info_ptr &this_frame,
     error (_("an Unwinder should return gdb.UnwindInfo, not %s."),
 	   Py_TYPE (pyo_unwind_info)->tp_name);
 
-  {
-    unwind_info_object *unwind_info =
-      (unwind_info_object *) pyo_unwind_info;
-    int reg_count = unwind_info->saved_regs->size ();
-
-    cached_frame
-      = ((cached_frame_info *)
-	 xmalloc (sizeof (*cached_frame)
-		  + reg_count * sizeof (cached_frame->reg[0])));
-    cached_frame->gdbarch = gdbarch;
-    cached_frame->frame_id = unwind_info->frame_id;
-    cached_frame->reg_count = reg_count;
-
-    /* Populate registers array.  */
-    for (int i = 0; i < unwind_info->saved_regs->size (); ++i)
-      {
-	saved_reg *reg = &(*unwind_info->saved_regs)[i];
+  unwind_info_object *unwind_info = (unwind_info_object *) pyo_unwind_info;
 
-	struct value *value = value_object_to_value (reg->value.get ());
-	size_t data_size = register_size (gdbarch, reg->number);
+  result.claimed = true;
+  result.frame_id = unwind_info->frame_id;
+  result.regs.reserve (unwind_info->saved_regs->size ());
 
-	/* `value' validation was done before, just assert.  */
-	gdb_assert (value != NULL);
-	gdb_assert (data_size == value->type ()->length ());
+  /* Populate registers array.  */
+  for (const saved_reg &reg : *unwind_info->saved_regs)
+    {
+      struct value *value = value_object_to_value (reg.value.get ());
+      size_t data_size = register_size (gdbarch, reg.number);
 
-	cached_reg_t *cached = new (&cached_frame->reg[i]) cached_reg_t ();
-	cached->num = reg->number;
-	cached->data.resize (data_size);
-	gdb::array_view<const gdb_byte> contents = value->contents ();
-	cached->data.assign (contents.begin (), contents.end ());
-      }
-  }
+      /* `value' validation was done before, just assert.  */
+      gdb_assert (value != NULL);
+      gdb_assert (data_size == value->type ()->length ());
+
+      cached_reg_t &cached = result.regs.emplace_back ();
+      cached.num = reg.number;
+      gdb::array_view<const gdb_byte> contents = value->contents ();
+      cached.data.assign (contents.begin (), contents.end ());
+    }
 
-  *cache_ptr = cached_frame;
-  return 1;
+  return result;
+}
+
+/* Frame sniffer dispatch.  */
+
+int
+frame_unwind_python::sniff (const frame_info_ptr &this_frame,
+			    void **cache_ptr) const
+{
+  PYUW_SCOPED_DEBUG_ENTER_EXIT;
+
+  struct gdbarch *gdbarch = (struct gdbarch *) (this->unwind_data ());
+  CORE_ADDR pc = get_frame_pc (this_frame);
+
+  pyuw_debug_printf ("frame=%d, sp=%s, pc=%s",
+		     frame_relative_level (this_frame),
+		     paddress (gdbarch, get_frame_sp (this_frame)),
+		     paddress (gdbarch, pc));
+
+  if (!pyuw_filter.valid || pyuw_filter.pspace != current_program_space)
+    {
+      gdbpy_enter enter_py (gdbarch);
+      pyuw_update_pc_filter ();
+    }
+
+  if (!pyuw_filter.contains (pc))
+    {
+      pyuw_debug_printf ("no unwinder applies to this pc");
+      return 0;
+    }
+
+  /* The stack pointer may not be available, in which case the
+     outcome is not cached.  */
+  std::optional<pyuw_frame_key> key;
+  try
+    {
+      key = pyuw_frame_key { current_inferior (), gdbarch, pc,
+			     get_frame_sp (this_frame) };
+    }
+  catch (const gdb_exception_error &except)
+    {
+    }
+
+  if (key.has_value ())
+    {
+      auto it = pyuw_result_cache.find (*key);
+      if (it != pyuw_result_cache.end ())
+	{
+	  pyuw_debug_printf ("using cached result");
+	  if (!it->second.claimed)
+	    return 0;
+	  *cache_ptr = pyuw_make_cached_frame (gdbarch, it->second);
+	  return 1;
+	}
+    }
+
+  pyuw_frame_result result = pyuw_run_unwinders (gdbarch, this_frame);
+  bool claimed = result.claimed;
+  if (claimed)
+    *cache_ptr = pyuw_make_cached_frame (gdbarch, result);
+
+  if (key.has_value ())
+    pyuw_result_cache.emplace (*key, std::move (result));
+
+  return claimed;
 }
 
 /* Frame cache release shim.  */
@@ -1004,12 +1271,46 @@ pyuw_on_new_gdbarch (gdbarch *newarch)
     }
 }
 
+/* Observer for the objfile events.  The PC ranges of the unwinders,
+   and the frames they claim, may change with the list of objfiles.  */
+
+static void
+pyuw_on_objfiles_changed ()
+{
+  gdbpy_invalidate_unwinder_caches ();
+}
+
+/* Observer for the events after which the frames of the inferior may
+   have changed.  */
+
+static void
+pyuw_on_frames_changed ()
+{
+  pyuw_result_cache.clear ();
+}
+
 /* Initialize unwind machinery.  */
 
 static int
 gdbpy_initialize_unwind ()
 {
   gdb::observers::new_architecture.attach (pyuw_on_new_gdbarch, "py-unwind");
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *) { pyuw_on_objfiles_changed (); }, "py-unwind");
+  gdb::observers::free_objfile.attach
+    ([] (struct objfile *) { pyuw_on_objfiles_changed (); }, "py-unwind");
+  gdb::observers::all_objfiles_removed.attach
+    ([] (program_space *) { pyuw_on_objfiles_changed (); }, "py-unwind");
+  gdb::observers::target_resumed.attach
+    ([] (ptid_t) { pyuw_on_frames_changed (); }, "py-unwind");
+  gdb::observers::memory_changed.attach
+    ([] (inferior *, CORE_ADDR, ssize_t, const bfd_byte *)
+       { pyuw_on_frames_changed (); }, "py-unwind");
+  gdb::observers::register_changed.attach
+    ([] (const frame_info_ptr &, int) { pyuw_on_frames_changed (); },
+     "py-unwind");
+  gdb::observers::inferior_exit.attach
+    ([] (inferior *) { pyuw_on_frames_changed (); }, "py-unwind");
 
   if (gdbpy_type_ready (&pending_frame_object_type) < 0)
     return -1;
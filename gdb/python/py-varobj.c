@@ -17,6 +17,7 @@
 #include "varobj.h"
 #include "varobj-iter.h"
 #include "valprint.h"
+#include "cp-builtin-printers.h"
 
 /* A dynamic varobj iterator "class" for python pretty-printed
    varobjs.  This inherits struct varobj_iter.  */
@@ -25,6 +26,10 @@ struct py_varobj_iter : public varobj_iter
 {
   py_varobj_iter (struct varobj *var, gdbpy_ref<> &&pyiter,
 		  const value_print_options *opts);
+  py_varobj_iter (struct varobj *var, struct value *array,
+		  const value_print_options *opts);
+  py_varobj_iter (struct varobj *var, PyObject *builtin_printer,
+		  const value_print_options *opts);
   ~py_varobj_iter () override;
 
   std::unique_ptr<varobj_item> next () override;
@@ -41,7 +46,20 @@ struct py_varobj_iter : public varobj_iter
 
   /* The python iterator returned by the printer's 'children' method,
      or NULL if not available.  */
-  PyObject *m_iter;
+  PyObject *m_iter = nullptr;
+
+  /* The children, if the printer's 'children_array' method returned
+     them.  Listing them does not involve Python.  */
+  std::optional<gdbpy_array_children> m_array_children;
+
+  /* The printer, if it is one of GDB's built-in printers, and the
+     container it prints.  Listing its children does not involve Python
+     either.  */
+  PyObject *m_builtin_printer = nullptr;
+  builtin_libstdcxx_container *m_builtin = nullptr;
+
+  /* Whether the built-in printer's children have all been listed.  */
+  bool m_builtin_done = false;
 
   /* The print options to use.  */
   value_print_options m_opts;
@@ -54,6 +72,7 @@ py_varobj_iter::~py_varobj_iter ()
 {
   gdbpy_enter_varobj enter_py (m_var);
   Py_XDECREF (m_iter);
+  Py_XDECREF (m_builtin_printer);
 }
 
 /* Implementation of the 'next' method of pretty-printed varobj
@@ -66,6 +85,63 @@ py_varobj_iter::next ()
   varobj_item *vitem;
   const char *name = NULL;
 
+  if (m_array_children.has_value () || m_builtin != nullptr)
+    {
+      if (m_array_children.has_value ()
+	  ? m_next_raw_index >= m_array_children->size ()
+	  : m_builtin_done)
+	return NULL;
+
+      auto array_item = std::make_unique<varobj_item> ();
+      try
+	{
+	  if (m_array_children.has_value ())
+	    {
+	      array_item->name = m_array_children->name (m_next_raw_index);
+	      array_item->value
+		= release_value (m_array_children->child (m_next_raw_index));
+	    }
+	  else
+	    {
+	      struct value *child = m_builtin->child (m_next_raw_index);
+	      if (child == nullptr)
+		{
+		  m_builtin_done = true;
+		  return NULL;
+		}
+	      array_item->name = string_printf ("[%d]", m_next_raw_index);
+	      array_item->value = release_value (child);
+	    }
+	  if (array_item->value->lazy ())
+	    array_item->value->fetch_lazy ();
+	}
+      catch (const gdb_exception_error &except)
+	{
+	  /* As for the 'children' iterator, use the text of a memory
+	     error as the last item.  */
+	  if (except.error != MEMORY_ERROR)
+	    throw;
+
+	  std::string msg = except.what ();
+	  struct gdbarch *arch = (m_array_children.has_value ()
+				  ? m_array_children->arch ()
+				  : m_builtin->arch);
+	  struct type *char_type = builtin_type (arch)->builtin_char;
+	  array_item->name = string_printf ("<error at %d>", m_next_raw_index);
+	  array_item->value
+	    = release_value (value_cstring (msg.c_str (), msg.size (),
+					    char_type));
+	  if (m_array_children.has_value ())
+	    m_next_raw_index = m_array_children->size ();
+	  else
+	    m_builtin_done = true;
+	  return array_item;
+	}
+
+      m_next_raw_index++;
+      return array_item;
+    }
+
   if (!gdb_python_initialized)
     return NULL;
 
@@ -139,6 +215,30 @@ py_varobj_iter::py_varobj_iter (struct varobj *var, gdbpy_ref<> &&pyiter,
 {
 }
 
+/* Constructor of pretty-printed varobj iterators for printers that
+   provide the children of VAR as the elements of ARRAY.  */
+
+py_varobj_iter::py_varobj_iter (struct varobj *var, struct value *array,
+				const value_print_options *opts)
+  : m_var (var),
+    m_opts (*opts)
+{
+  m_array_children.emplace (array);
+}
+
+/* Constructor of varobj iterators for GDB's built-in printers.
+   BUILTIN_PRINTER is the printer of VAR.  */
+
+py_varobj_iter::py_varobj_iter (struct varobj *var,
+				PyObject *builtin_printer,
+				const value_print_options *opts)
+  : m_var (var),
+    m_builtin_printer (Py_NewRef (builtin_printer)),
+    m_builtin (gdbpy_get_builtin_printer_container (builtin_printer)),
+    m_opts (*opts)
+{
+}
+
 /* Return a new pretty-printed varobj iterator suitable to iterate
    over VAR's children.  */
 
@@ -148,12 +248,25 @@ py_varobj_get_iterator (struct varobj *var, PyObject *printer,
 {
   gdbpy_enter_varobj enter_py (var);
 
-  if (!PyObject_HasAttr (printer, gdbpy_children_cst))
-    return NULL;
-
   scoped_restore set_options = make_scoped_restore (&gdbpy_current_print_options,
 						    opts);
 
+  if (gdbpy_get_builtin_printer_container (printer) != nullptr)
+    return std::make_unique<py_varobj_iter> (var, printer, opts);
+
+  gdb::unique_xmalloc_ptr<char> hint = gdbpy_get_display_hint (printer);
+  struct value *array = gdbpy_get_children_array (printer, hint.get ());
+  if (array != nullptr)
+    return std::make_unique<py_varobj_iter> (var, array, opts);
+  else if (PyErr_Occurred ())
+    {
+      gdbpy_print_stack ();
+      error (_("Invalid value returned by children_array"));
+    }
+
+  if (!PyObject_HasAttr (printer, gdbpy_children_cst))
+    return NULL;
+
   gdbpy_ref<> children (PyObject_CallMethodObjArgs (printer, gdbpy_children_cst,
 						    NULL));
   if (children == NULL)
@@ -541,6 +541,7 @@ struct value *value_object_to_value (PyObject *self);
 struct value *convert_value_from_python (PyObject *obj);
 struct type *type_object_to_type (PyObject *obj);
 struct symtab *symtab_object_to_symtab (PyObject *obj);
+struct objfile *objfile_object_to_objfile (PyObject *obj);
 struct symtab_and_line *sal_object_to_symtab_and_line (PyObject *obj);
 frame_info_ptr frame_object_to_frame_info (PyObject *frame_obj);
 struct gdbarch *arch_object_to_gdbarch (PyObject *obj);
@@ -963,7 +964,74 @@ gdbpy_ref<> apply_varobj_pretty_printer (PyObject *print_obj,
 					 const value_print_options *opts);
 gdbpy_ref<> gdbpy_get_varobj_pretty_printer (struct value *value);
 gdb::unique_xmalloc_ptr<char> gdbpy_get_display_hint (PyObject *printer);
+struct value *gdbpy_get_children_array (PyObject *printer,
+					const char *hint);
+struct builtin_libstdcxx_container *gdbpy_get_builtin_printer_container
+  (PyObject *printer);
 PyObject *gdbpy_default_visualizer (PyObject *self, PyObject *args);
+PyObject *gdbpy_invalidate_cached_pretty_printers (PyObject *self,
+						   PyObject *args);
+
+/* Forget which pretty-printer lookup function was found for each
+   type.  */
+void gdbpy_invalidate_pretty_printer_cache ();
+
+/* Forget what is known about the PC ranges the Python unwinders apply
+   to, and the frames they have unwound.  */
+
+void gdbpy_invalidate_unwinder_caches ();
+
+/* The children of a value whose pretty-printer provides them as an
+   array in memory, through its children_array method.  The elements
+   are read from memory in batches, as they are accessed.  */
+
+class gdbpy_array_children
+{
+public:
+
+  /* ARRAY is the value returned by gdbpy_get_children_array.  */
+  explicit gdbpy_array_children (struct value *array);
+
+  /* Return the number of children.  */
+  LONGEST size () const
+  { return m_size; }
+
+  /* Return the architecture of the array.  */
+  struct gdbarch *arch () const
+  { return m_array->type ()->arch (); }
+
+  /* Return the name of child N, that is its index in the array.  */
+  std::string name (LONGEST n) const;
+
+  /* Return the value of child N, reading the batch of elements holding
+     it from memory if needed.  If the batch can't be read, the value
+     is lazy, and reading it reports the error.  */
+  struct value *child (LONGEST n);
+
+private:
+
+  /* The array holding the children.  */
+  value_ref_ptr m_array;
+
+  /* The lower bound of the array.  */
+  LONGEST m_low = 0;
+
+  /* The number of elements in the array.  */
+  LONGEST m_size = 0;
+
+  /* The number of elements read from memory at once.  */
+  LONGEST m_batch_size = 1;
+
+  /* A slice of M_ARRAY holding the elements read last, starting at
+     element M_BATCH_START, or NULL.  */
+  value_ref_ptr m_batch;
+  LONGEST m_batch_start = 0;
+
+  /* The elements, from M_UNREADABLE_START up to but not including
+     M_UNREADABLE_END, of the last batch that could not be read.  */
+  LONGEST m_unreadable_start = 0;
+  LONGEST m_unreadable_end = 0;
+};
 
 PyObject *gdbpy_print_options (PyObject *self, PyObject *args);
 void gdbpy_get_print_options (value_print_options *opts);
@@ -975,6 +1043,7 @@ void bpfinishpy_pre_delete_hook (struct gdbpy_breakpoint_object *bp_obj);
 
 extern PyObject *gdbpy_doc_cst;
 extern PyObject *gdbpy_children_cst;
+extern PyObject *gdbpy_children_array_cst;
 extern PyObject *gdbpy_to_string_cst;
 extern PyObject *gdbpy_display_hint_cst;
 extern PyObject *gdbpy_enabled_cst;
@@ -91,6 +91,7 @@ PyObject *gdb_python_module;
 /* Some string constants we may wish to use.  */
 PyObject *gdbpy_to_string_cst;
 PyObject *gdbpy_children_cst;
+PyObject *gdbpy_children_array_cst;
 PyObject *gdbpy_display_hint_cst;
 PyObject *gdbpy_doc_cst;
 PyObject *gdbpy_enabled_cst;
@@ -1103,6 +1104,7 @@ gdbpy_parse_and_eval (PyObject *self, PyObject *args, PyObject *kw)
 static PyObject *
 gdbpy_invalidate_cached_frames (PyObject *self, PyObject *args)
 {
+  gdbpy_invalidate_unwinder_caches ();
   reinit_frame_cache ();
   Py_RETURN_NONE;
 }
@@ -2655,6 +2657,9 @@ do_start_initialization ()
   gdbpy_children_cst = PyUnicode_FromString ("children");
   if (gdbpy_children_cst == NULL)
     return false;
+  gdbpy_children_array_cst = PyUnicode_FromString ("children_array");
+  if (gdbpy_children_array_cst == NULL)
+    return false;
   gdbpy_display_hint_cst = PyUnicode_FromString ("display_hint");
   if (gdbpy_display_hint_cst == NULL)
     return false;
@@ -3030,6 +3035,10 @@ Arguments (also strings) are passed to the command." },
 
   { "default_visualizer", gdbpy_default_visualizer, METH_VARARGS,
     "Find the default visualizer for a Value." },
+  { "invalidate_cached_pretty_printers",
+    gdbpy_invalidate_cached_pretty_printers, METH_NOARGS,
+    "invalidate_cached_pretty_printers () -> None.\n\
+Forget which pretty-printer lookup function was found for each type." },
 
   { "progspaces", gdbpy_progspaces, METH_NOARGS,
     "Return a sequence of all progspaces." },
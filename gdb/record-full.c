@@ -41,6 +41,7 @@
 #include "gdbsupport/gdb_unlinker.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/scoped_signal_handler.h"
+#include "gdbsupport/unordered_map.h"
 #include "async-event.h"
 #include "top.h"
 #include "valprint.h"
@@ -392,6 +393,76 @@ static struct cmd_list_element *record_full_cmdlist;
 static void record_full_goto_insn (struct record_full_entry *entry,
 				   enum exec_direction_kind dir);
 
+/* Execution log entries are small and there are typically several per
+   recorded instruction, so allocating each with its own malloc call
+   wastes a good part of the memory on allocator overhead and makes
+   releasing the log slow.  Instead, entries are carved out of large
+   chunks and recycled through a free list, linked by their NEXT
+   field.  */
+
+#define RECORD_FULL_ENTRY_CHUNK_SIZE 4096
+
+/* The chunks entries are allocated from.  */
+static std::vector<std::unique_ptr<record_full_entry[]>>
+  record_full_entry_chunks;
+
+/* Entries available for reuse.  */
+static struct record_full_entry *record_full_entry_free_list;
+
+/* Number of entries currently handed out.  */
+static size_t record_full_entry_live_count;
+
+/* Return a new zero-initialized execution log entry.  */
+
+static struct record_full_entry *
+record_full_entry_new ()
+{
+  if (record_full_entry_free_list == nullptr)
+    {
+      record_full_entry *chunk
+	= new record_full_entry[RECORD_FULL_ENTRY_CHUNK_SIZE];
+      record_full_entry_chunks.emplace_back (chunk);
+
+      for (int i = RECORD_FULL_ENTRY_CHUNK_SIZE - 1; i >= 0; --i)
+	{
+	  chunk[i].next = record_full_entry_free_list;
+	  record_full_entry_free_list = &chunk[i];
+	}
+    }
+
+  struct record_full_entry *rec = record_full_entry_free_list;
+  record_full_entry_free_list = rec->next;
+  ++record_full_entry_live_count;
+
+  memset (rec, 0, sizeof (*rec));
+  return rec;
+}
+
+/* Return REC to the free list.  */
+
+static void
+record_full_entry_free (struct record_full_entry *rec)
+{
+  gdb_assert (record_full_entry_live_count > 0);
+  --record_full_entry_live_count;
+
+  rec->next = record_full_entry_free_list;
+  record_full_entry_free_list = rec;
+}
+
+/* Give the memory of the entry chunks back, provided no entry is in
+   use anymore.  */
+
+static void
+record_full_entry_pool_release ()
+{
+  if (record_full_entry_live_count != 0)
+    return;
+
+  record_full_entry_free_list = nullptr;
+  record_full_entry_chunks.clear ();
+}
+
 /* Alloc and free functions for record_full_reg, record_full_mem, and
    record_full_end entries.  */
 
@@ -403,7 +474,7 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = regcache->arch ();
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_new ();
   rec->type = record_full_reg;
   rec->u.reg.num = regnum;
   rec->u.reg.len = register_size (gdbarch, regnum);
@@ -421,7 +492,7 @@ record_full_reg_release (struct record_full_entry *rec)
   gdb_assert (rec->type == record_full_reg);
   if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
     xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -431,7 +502,7 @@ record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_new ();
   rec->type = record_full_mem;
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
@@ -449,7 +520,7 @@ record_full_mem_release (struct record_full_entry *rec)
   gdb_assert (rec->type == record_full_mem);
   if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
     xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -459,7 +530,7 @@ record_full_end_alloc (void)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_new ();
   rec->type = record_full_end;
 
   return rec;
@@ -470,7 +541,7 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Free one record entry, any type.
@@ -908,6 +979,300 @@ record_full_exec_insn (struct regcache *regcache,
     }
 }
 
+/* The number of instructions whose changes record_full_replay_batch
+   gathers before writing them to the target, for "set record full
+   replay-batch-size".  UINT_MAX, which is what both 0 and "unlimited"
+   are stored as, means no limit.  */
+static unsigned int record_full_replay_batch_size = 65536;
+
+/* The size of the blocks in which record_full_replay_batch keeps the
+   contents of memory.  */
+#define RECORD_FULL_BATCH_PAGE_SIZE 4096
+
+/* Replaying the execution log with record_full_exec_insn writes every
+   register and memory change to the target as it goes.  Over many
+   instructions, that is mostly the same few registers and stack slots
+   being written again and again, each write going through the whole
+   target stack.
+
+   This class replays log entries against copies of the registers and
+   memory they touch instead.  Each location is read from the target
+   the first time it is touched, and the final contents are written
+   back when the batch is flushed, which happens at the latest every
+   record_full_replay_batch_size instructions.  The entries of the log
+   are updated exactly as record_full_exec_insn updates them.  */
+
+class record_full_replay_batch
+{
+public:
+  explicit record_full_replay_batch (struct regcache *regcache)
+    : m_regcache (regcache),
+      m_gdbarch (regcache->arch ()),
+      m_regs (gdbarch_num_cooked_regs (m_gdbarch)),
+      m_reg_dirty (gdbarch_num_cooked_regs (m_gdbarch))
+  {}
+
+  DISABLE_COPY_AND_ASSIGN (record_full_replay_batch);
+
+  /* Replay ENTRY, like record_full_exec_insn.  */
+  void exec (struct record_full_entry *entry);
+
+  /* Note that a whole instruction was replayed, and flush the batch if
+   it is full.  */
+  void end_insn ()
+  {
+    if (record_full_replay_batch_size != 0
+	&& ++m_insns >= record_full_replay_batch_size)
+      flush ();
+  }
+
+  /* Return the PC the replayed registers hold.  */
+  CORE_ADDR read_pc ();
+
+  /* Write the replayed registers and memory to the target.  */
+  void flush ();
+
+  /* Like flush, but for use while another exception is in flight:
+     errors are only reported, not thrown.  */
+  void flush_noexcept () noexcept;
+
+private:
+  /* The contents of a block of memory.  */
+  struct page
+  {
+    page ()
+      : contents (RECORD_FULL_BATCH_PAGE_SIZE),
+	loaded (RECORD_FULL_BATCH_PAGE_SIZE),
+	dirty (RECORD_FULL_BATCH_PAGE_SIZE)
+    {}
+
+    /* The contents of memory, where LOADED is set.  */
+    gdb::byte_vector contents;
+
+    /* For each byte, whether it was read from the target.  */
+    gdb::byte_vector loaded;
+
+    /* For each byte, whether it was changed by the replay.  */
+    gdb::byte_vector dirty;
+  };
+
+  /* Make sure the LEN bytes of memory at ADDR are loaded.  Return
+     false if they cannot be read.  */
+  bool load_memory (CORE_ADDR addr, int len);
+
+  /* The registers of the replayed thread.  */
+  struct regcache *m_regcache;
+  struct gdbarch *m_gdbarch;
+
+  /* The contents of each register, or empty if it was not read yet.  */
+  std::vector<gdb::byte_vector> m_regs;
+
+  /* Whether each register was changed by the replay.  */
+  std::vector<bool> m_reg_dirty;
+
+  /* The blocks of memory touched by the replay, by start address.  */
+  gdb::unordered_map<CORE_ADDR, page> m_pages;
+
+  /* The number of instructions replayed since the last flush.  */
+  unsigned int m_insns = 0;
+};
+
+/* See record_full_replay_batch.  */
+
+bool
+record_full_replay_batch::load_memory (CORE_ADDR addr, int len)
+{
+  CORE_ADDR end = addr + len;
+
+  while (addr < end)
+    {
+      CORE_ADDR base = addr - addr % RECORD_FULL_BATCH_PAGE_SIZE;
+      size_t off = addr - base;
+      size_t n = std::min<CORE_ADDR> (end - addr,
+				      RECORD_FULL_BATCH_PAGE_SIZE - off);
+      page &pg = m_pages[base];
+
+      /* Read each run of bytes not loaded yet.  */
+      for (size_t i = off; i < off + n; )
+	{
+	  if (pg.loaded[i])
+	    {
+	      ++i;
+	      continue;
+	    }
+
+	  size_t run = i;
+	  while (run < off + n && !pg.loaded[run])
+	    ++run;
+	  if (record_read_memory (m_gdbarch, base + i,
+				  pg.contents.data () + i, run - i))
+	    return false;
+	  memset (pg.loaded.data () + i, 1, run - i);
+	  i = run;
+	}
+
+      addr += n;
+    }
+
+  return true;
+}
+
+/* See record_full_replay_batch.  */
+
+void
+record_full_replay_batch::exec (struct record_full_entry *entry)
+{
+  switch (entry->type)
+    {
+    case record_full_reg:
+      {
+	int num = entry->u.reg.num;
+	gdb::byte_vector &reg = m_regs[num];
+
+	if (record_debug > 1)
+	  gdb_printf (gdb_stdlog,
+		      "Process record: record_full_reg %s to "
+		      "inferior num = %d.\n",
+		      host_address_to_string (entry), num);
+
+	if (reg.empty ())
+	  {
+	    reg.resize (entry->u.reg.len);
+	    m_regcache->cooked_read (num, reg.data ());
+	  }
+
+	std::swap_ranges (reg.begin (), reg.end (),
+			  record_full_get_loc (entry));
+	m_reg_dirty[num] = true;
+      }
+      break;
+
+    case record_full_mem:
+      {
+	/* Nothing to do if the entry is flagged not_accessible.  */
+	if (entry->u.mem.mem_entry_not_accessible)
+	  break;
+
+	CORE_ADDR addr = entry->u.mem.addr;
+	int len = entry->u.mem.len;
+
+	if (record_debug > 1)
+	  gdb_printf (gdb_stdlog,
+		      "Process record: record_full_mem %s to "
+		      "inferior addr = %s len = %d.\n",
+		      host_address_to_string (entry),
+		      paddress (m_gdbarch, addr), len);
+
+	if (!load_memory (addr, len))
+	  {
+	    entry->u.mem.mem_entry_not_accessible = 1;
+	    break;
+	  }
+
+	gdb_byte *loc = record_full_get_loc (entry);
+	for (int i = 0; i < len; )
+	  {
+	    CORE_ADDR a = addr + i;
+	    CORE_ADDR base = a - a % RECORD_FULL_BATCH_PAGE_SIZE;
+	    size_t off = a - base;
+	    size_t n = std::min<size_t> (len - i,
+					 RECORD_FULL_BATCH_PAGE_SIZE - off);
+	    page &pg = m_pages[base];
+
+	    std::swap_ranges (pg.contents.data () + off,
+			      pg.contents.data () + off + n, loc + i);
+	    memset (pg.dirty.data () + off, 1, n);
+	    i += n;
+	  }
+
+	/* See record_full_exec_insn.  */
+	if (hardware_watchpoint_inserted_in_range
+	    (current_inferior ()->aspace.get (), addr, len))
+	  record_full_stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
+      }
+      break;
+    }
+}
+
+/* See record_full_replay_batch.  */
+
+CORE_ADDR
+record_full_replay_batch::read_pc ()
+{
+  int pc_regnum = gdbarch_pc_regnum (m_gdbarch);
+
+  /* Only the PC register itself can be read from the copies.  */
+  if (gdbarch_read_pc_p (m_gdbarch) || pc_regnum < 0)
+    {
+      flush ();
+      return regcache_read_pc (m_regcache);
+    }
+
+  const gdb::byte_vector &reg = m_regs[pc_regnum];
+  if (reg.empty ())
+    return regcache_read_pc (m_regcache);
+
+  ULONGEST raw_val
+    = extract_unsigned_integer (reg.data (), reg.size (),
+				gdbarch_byte_order (m_gdbarch));
+  return gdbarch_addr_bits_remove (m_gdbarch, raw_val);
+}
+
+/* See record_full_replay_batch.  */
+
+void
+record_full_replay_batch::flush ()
+{
+  m_insns = 0;
+
+  for (int num = 0; num < m_regs.size (); ++num)
+    if (m_reg_dirty[num])
+      {
+	m_reg_dirty[num] = false;
+	m_regcache->cooked_write (num, m_regs[num].data ());
+      }
+  m_regs.assign (m_regs.size (), gdb::byte_vector ());
+
+  /* Write each run of changed bytes.  The pages are dropped first, so
+     that an error leaves the batch empty.  */
+  gdb::unordered_map<CORE_ADDR, page> pages = std::move (m_pages);
+  m_pages.clear ();
+  for (const auto &[base, pg] : pages)
+    for (size_t i = 0; i < RECORD_FULL_BATCH_PAGE_SIZE; )
+      {
+	if (!pg.dirty[i])
+	  {
+	    ++i;
+	    continue;
+	  }
+
+	size_t run = i;
+	while (run < RECORD_FULL_BATCH_PAGE_SIZE && pg.dirty[run])
+	  ++run;
+	if (target_write_memory (base + i, pg.contents.data () + i, run - i)
+	    && record_debug)
+	  warning (_("Process record: error writing memory at "
+		     "addr = %s len = %d."),
+		   paddress (m_gdbarch, base + i), (int) (run - i));
+	i = run;
+      }
+}
+
+/* See record_full_replay_batch.  */
+
+void
+record_full_replay_batch::flush_noexcept () noexcept
+{
+  try
+    {
+      flush ();
+    }
+  catch (const gdb_exception &ex)
+    {
+      exception_print (gdb_stderr, ex);
+    }
+}
+
 static void record_full_restore (struct bfd &cbfd);
 
 /* Asynchronous signal handle registered as event loop source for when
@@ -1014,6 +1379,7 @@ record_full_base_target::close ()
     gdb_printf (gdb_stdlog, "Process record: record_full_close\n");
 
   record_full_list_release (record_full_list);
+  record_full_entry_pool_release ();
 
   /* Release record_full_core_regbuf.  */
   if (record_full_core_regbuf)
@@ -1311,6 +1677,7 @@ record_full_wait_1 (struct target_ops *ops,
       const address_space *aspace = current_inferior ()->aspace.get ();
       int continue_flag = 1;
       int first_record_full_end = 1;
+      record_full_replay_batch batch (regcache);
 
       try
 	{
@@ -1366,7 +1733,7 @@ record_full_wait_1 (struct target_ops *ops,
 		  break;
 		}
 
-	      record_full_exec_insn (regcache, gdbarch, record_full_list);
+	      batch.exec (record_full_list);
 
 	      if (record_full_list->type == record_full_end)
 		{
@@ -1377,6 +1744,8 @@ record_full_wait_1 (struct target_ops *ops,
 		       "inferior.\n",
 		       host_address_to_string (record_full_list));
 
+		  batch.end_insn ();
+
 		  if (first_record_full_end
 		      && execution_direction == EXEC_REVERSE)
 		    {
@@ -1401,7 +1770,7 @@ record_full_wait_1 (struct target_ops *ops,
 			}
 
 		      /* check breakpoint */
-		      tmp_pc = regcache_read_pc (regcache);
+		      tmp_pc = batch.read_pc ();
 		      if (record_check_stopped_by_breakpoint
 			  (aspace, tmp_pc, &record_full_stop_reason))
 			{
@@ -1447,6 +1816,7 @@ record_full_wait_1 (struct target_ops *ops,
 	  while (continue_flag);
 
 	replay_out:
+	  batch.flush ();
 	  if (status->kind () == TARGET_WAITKIND_STOPPED)
 	    {
 	      if (record_full_get_sig)
@@ -1460,6 +1830,8 @@ record_full_wait_1 (struct target_ops *ops,
 	}
       catch (const gdb_exception &ex)
 	{
+	  batch.flush_noexcept ();
+
 	  if (execution_direction == EXEC_REVERSE)
 	    {
 	      if (record_full_list->next)
@@ -2745,7 +3117,7 @@ record_full_goto_insn (struct record_full_entry *entry,
   scoped_restore restore_operation_disable
     = record_full_gdb_operation_disable_set ();
   regcache *regcache = get_thread_regcache (inferior_thread ());
-  struct gdbarch *gdbarch = regcache->arch ();
+  record_full_replay_batch batch (regcache);
 
   /* Assume everything is valid: we will hit the entry,
      and we will not hit the end of the recording.  */
@@ -2753,14 +3125,26 @@ record_full_goto_insn (struct record_full_entry *entry,
   if (dir == EXEC_FORWARD)
     record_full_list = record_full_list->next;
 
-  do
+  try
     {
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
-      if (dir == EXEC_REVERSE)
-	record_full_list = record_full_list->prev;
-      else
-	record_full_list = record_full_list->next;
-    } while (record_full_list != entry);
+      do
+	{
+	  batch.exec (record_full_list);
+	  if (record_full_list->type == record_full_end)
+	    batch.end_insn ();
+	  if (dir == EXEC_REVERSE)
+	    record_full_list = record_full_list->prev;
+	  else
+	    record_full_list = record_full_list->next;
+	} while (record_full_list != entry);
+
+      batch.flush ();
+    }
+  catch (const gdb_exception &ex)
+    {
+      batch.flush_noexcept ();
+      throw;
+    }
 }
 
 /* Alias for "target record-full".  */
@@ -2943,6 +3327,19 @@ limit.  Default is 200000."),
 				NULL, &set_record_full_cmdlist,
 				&show_record_full_cmdlist);
 
+  add_setshow_uinteger_cmd ("replay-batch-size", no_class,
+			    &record_full_replay_batch_size,
+			    _("Set the number of instructions replayed "
+			      "between target writes."),
+			    _("Show the number of instructions replayed "
+			      "between target writes."), _("\
+When replaying the execution log, the register and memory changes of\n\
+this many instructions are gathered in GDB before being written to the\n\
+target.  A value of either \"unlimited\" or zero means no limit.\n\
+Default is 65536."),
+			    NULL, NULL, &set_record_full_cmdlist,
+			    &show_record_full_cmdlist);
+
   c = add_alias_cmd ("insn-number-max", record_full_insn_number_max_cmds.set,
 		     no_class, 1, &set_record_cmdlist);
   deprecate_cmd (c, "set record full insn-number-max");
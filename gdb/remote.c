@@ -79,11 +79,13 @@
 #include "gdbsupport/search.h"
 #include <algorithm>
 #include <iterator>
+#include <deque>
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
 #include "cli/cli-style.h"
 #include "gdbsupport/remote-args.h"
 #include "finish-thread-state.h"
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -419,6 +421,14 @@ enum {
      the most likely watchpoint to show to the user.  */
   PACKET_multi_wp_addr,
 
+  /* Support for receiving several memory read requests before
+     replying to the first one.  */
+  PACKET_pipelined_reads,
+
+  /* Not really a packet; this indicates support for zlib-compressed
+     replies to bulk data transfer requests.  */
+  PACKET_zlib_compression,
+
   PACKET_MAX
 };
 
@@ -473,9 +483,20 @@ struct readahead_cache
   /* The buffer holding the cache contents.  */
   gdb::byte_vector buf;
 
+  /* The number of bytes to read ahead on the next miss, if it
+     continues a sequential read of the file.  */
+  size_t window = 0;
+
   /* Cache hit and miss counters.  */
   ULONGEST hit_count = 0;
   ULONGEST miss_count = 0;
+
+  /* The number of vFile:pread requests sent, the number of times GDB
+     had to wait for a reply before it could send more requests, and
+     the number of bytes of file data received.  */
+  ULONGEST pread_requests = 0;
+  ULONGEST round_trips = 0;
+  ULONGEST bytes_read = 0;
 };
 
 /* Description of the remote protocol for a given architecture.  */
@@ -516,6 +537,38 @@ struct remote_arch_state
   long remote_packet_size;
 };
 
+/* The kinds of replies that the stub may send compressed, once
+   zlib-compression has been negotiated.  */
+
+enum remote_compressed_reply_kind
+{
+  /* Replies to 'm' and 'x' memory reads.  */
+  REMOTE_COMPRESSED_MEMORY,
+
+  /* Replies to qXfer:OBJECT:read requests.  */
+  REMOTE_COMPRESSED_QXFER,
+
+  /* Replies to vFile:pread requests.  */
+  REMOTE_COMPRESSED_VFILE_PREAD,
+
+  REMOTE_COMPRESSED_MAX
+};
+
+/* Traffic statistics for one kind of compressible reply.  */
+
+struct remote_compression_stats
+{
+  /* The number of replies received, and how many of those were
+     compressed.  */
+  ULONGEST replies = 0;
+  ULONGEST compressed_replies = 0;
+
+  /* The number of payload bytes received over the wire, and the
+     number of bytes after decompression.  */
+  ULONGEST wire_bytes = 0;
+  ULONGEST payload_bytes = 0;
+};
+
 /* Description of the remote protocol state for the currently
    connected target.  This is per-target state, and independent of the
    selected architecture.  */
@@ -695,6 +748,10 @@ class remote_state
      file descriptor at a time.  */
   struct readahead_cache readahead_cache;
 
+  /* Statistics about the replies that the stub may compress, indexed
+     by remote_compressed_reply_kind.  */
+  remote_compression_stats compression_stats[REMOTE_COMPRESSED_MAX];
+
   /* The list of already fetched and acknowledged stop events.  This
      queue is used for notification Stop, and other notifications
      don't need queue for their events, because the notification
@@ -1282,10 +1339,20 @@ class remote_target : public process_stratum_target
 			    ULONGEST offset, fileio_error *remote_errno);
   int remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 				 ULONGEST offset, fileio_error *remote_errno);
+  int remote_hostio_pread_pipelined (int fd, gdb_byte *read_buf, int len,
+				     ULONGEST offset,
+				     fileio_error *remote_errno);
+  void remote_hostio_send_pread (int fd, int len, ULONGEST offset);
+  int remote_hostio_read_pread_reply (gdb_byte *read_buf, int len,
+				      fileio_error *remote_errno,
+				      bool pipelined = false);
 
   int remote_hostio_send_command (int command_bytes, int which_packet,
 				  fileio_error *remote_errno, const char **attachment,
 				  int *attachment_len);
+  int remote_hostio_read_reply (int which_packet, fileio_error *remote_errno,
+				const char **attachment, int *attachment_len,
+				bool pipelined = false);
   int remote_hostio_set_filesystem (struct inferior *inf,
 				    fileio_error *remote_errno);
   /* We should get rid of this and use fileio_open directly.  */
@@ -1456,6 +1523,18 @@ class remote_target : public process_stratum_target
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
 
+  target_xfer_status remote_read_bytes_pipelined (CORE_ADDR memaddr,
+						  gdb_byte *myaddr,
+						  ULONGEST len_units,
+						  int unit_size,
+						  ULONGEST chunk_units,
+						  char packet_format,
+						  ULONGEST *xfered_len_units);
+
+  int decompress_reply (int packet_len, remote_compressed_reply_kind kind);
+
+  int getpkt_pipelined_reply ();
+
   target_xfer_status remote_xfer_live_readonly_partial (gdb_byte *readbuf,
 							ULONGEST memaddr,
 							ULONGEST len,
@@ -6264,6 +6343,10 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_vRun_single_argument },
   { "multi-watchpoint-addr", PACKET_ENABLE, remote_supported_packet,
     PACKET_multi_wp_addr },
+  { "pipelined-reads", PACKET_DISABLE, remote_supported_packet,
+    PACKET_pipelined_reads },
+  { "zlib-compression", PACKET_DISABLE, remote_supported_packet,
+    PACKET_zlib_compression },
 };
 
 static char *remote_support_xml;
@@ -6394,6 +6477,10 @@ remote_target::remote_query_supported ()
 	  != AUTO_BOOLEAN_FALSE)
 	remote_query_supported_append (&q, "multi-wp-addr+");
 
+      if (m_features.packet_set_cmd_state (PACKET_zlib_compression)
+	  != AUTO_BOOLEAN_FALSE)
+	remote_query_supported_append (&q, "zlib-compression+");
+
       q = "qSupported:" + q;
       putpkt (q.c_str ());
 
@@ -10091,6 +10178,104 @@ remote_target::remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr,
 				 packet_format[0], 1);
 }
 
+/* If the reply of length PACKET_LEN in the packet buffer is
+   compressed, replace it with the decompressed reply, and return the
+   new length.  Otherwise, return PACKET_LEN unchanged.  KIND says what
+   kind of request the reply answers, and is used for statistics.
+
+   A compressed reply has the form "Z<length>;<data>", where LENGTH is
+   the length in hex of the original reply, and DATA is the binary
+   escaped zlib stream holding it.  The stub only sends such replies
+   to bulk transfer requests once zlib-compression has been
+   negotiated, and none of those requests has replies starting with
+   'Z' otherwise.  */
+
+int
+remote_target::decompress_reply (int packet_len,
+				 remote_compressed_reply_kind kind)
+{
+  struct remote_state *rs = get_remote_state ();
+  remote_compression_stats &stats = rs->compression_stats[kind];
+
+  stats.replies++;
+  stats.wire_bytes += packet_len;
+
+  if (packet_len < 1
+      || rs->buf[0] != 'Z'
+      || (m_features.packet_support (PACKET_zlib_compression)
+	  != PACKET_ENABLE))
+    {
+      stats.payload_bytes += packet_len;
+      return packet_len;
+    }
+
+  ULONGEST reply_len;
+  const char *p = unpack_varlen_hex (rs->buf.data () + 1, &reply_len);
+  if (*p != ';' || reply_len > INT_MAX - 1)
+    error (_("Invalid compressed reply from remote: %s"), rs->buf.data ());
+  p++;
+
+  int data_len = packet_len - (p - rs->buf.data ());
+  gdb::byte_vector data (data_len);
+  data_len = remote_unescape_input ((const gdb_byte *) p, data_len,
+				    data.data (), data_len);
+
+  if (rs->buf.size () < reply_len + 1)
+    rs->buf.resize (reply_len + 1);
+
+  uLongf dest_len = reply_len;
+  if (uncompress ((Bytef *) rs->buf.data (), &dest_len, data.data (),
+		  data_len) != Z_OK
+      || dest_len != reply_len)
+    error (_("Remote sent a corrupt compressed reply."));
+  rs->buf[reply_len] = '\0';
+
+  remote_debug_printf ("decompressed reply: %d -> %s bytes",
+		       packet_len, pulongest (reply_len));
+
+  stats.compressed_replies++;
+  stats.payload_bytes += reply_len;
+  return reply_len;
+}
+
+/* Decode the reply in BUF to a memory read request sent in
+   PACKET_FORMAT ('m' or 'x') into MYADDR, which has room for
+   MAX_BYTES bytes.  PACKET_LEN is the length of the reply.  Return
+   the number of bytes decoded, or -1 if the reply is an error.  */
+
+static int
+decode_memory_read_reply (const gdb::char_vector &buf, int packet_len,
+			  char packet_format, gdb_byte *myaddr,
+			  int max_bytes)
+{
+  packet_result result = packet_check_result (buf);
+  if (result.status () == PACKET_ERROR)
+    return -1;
+
+  const char *p = buf.data ();
+  if (packet_format == 'x')
+    {
+      if (*p != 'b')
+	return -1;
+
+      /* Adjust for 'b'.  */
+      p++;
+      packet_len--;
+      return remote_unescape_input ((const gdb_byte *) p, packet_len,
+				    myaddr, max_bytes);
+    }
+
+  /* Reply describes memory byte by byte, each byte encoded as two hex
+     characters.  */
+  return hex2bin (p, myaddr, max_bytes);
+}
+
+/* The maximum number of memory read requests sent to the stub before
+   waiting for the replies, when the stub supports pipelined
+   reads.  */
+
+#define REMOTE_READ_PIPELINE_DEPTH 16
+
 /* Read memory data directly from the remote machine.
    This does not use the data cache; the data cache uses this.
    MEMADDR is the address in the remote memory space.
@@ -10123,6 +10308,22 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   todo_units = std::min (len_units,
 			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
 
+  /* If the read doesn't fit in a single packet, and the stub lets us
+     send several requests before reading the replies, avoid paying a
+     round trip for each packet.  Without acks, the requests can be
+     streamed out back-to-back.  This needs to know which packet
+     format the stub supports, so the very first read always goes
+     through the path below.  */
+  if (len_units > todo_units
+      && rs->noack_mode
+      && m_features.packet_support (PACKET_pipelined_reads) == PACKET_ENABLE
+      && m_features.packet_support (PACKET_x) != PACKET_SUPPORT_UNKNOWN)
+    return remote_read_bytes_pipelined (memaddr, myaddr, len_units,
+					unit_size, todo_units,
+					(m_features.packet_support (PACKET_x)
+					 == PACKET_ENABLE ? 'x' : 'm'),
+					xfered_len_units);
+
   memaddr = remote_address_masked (memaddr);
 
   /* Construct "m/x"<memaddr>","<len>".  */
@@ -10172,32 +10373,132 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
 	}
     }
 
-  packet_result result = packet_check_result (rs->buf);
-  if (result.status () == PACKET_ERROR)
+  packet_len = decompress_reply (packet_len, REMOTE_COMPRESSED_MEMORY);
+  decoded_bytes = decode_memory_read_reply (rs->buf, packet_len,
+					    packet_format, myaddr,
+					    todo_units * unit_size);
+  if (decoded_bytes < 0)
     return TARGET_XFER_E_IO;
 
-  char *p = rs->buf.data ();
-  if (packet_format == 'x')
+  /* Return what we have.  Let higher layers handle partial reads.  */
+  *xfered_len_units = (ULONGEST) (decoded_bytes / unit_size);
+  return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
+}
+
+/* Read the reply to one of several requests sent back-to-back into
+   the packet buffer, and return its length.  If the reply cannot be
+   received, it may have been lost or may still arrive late; either
+   way, the replies still to come can no longer be matched with their
+   requests, so the connection is closed.  */
+
+int
+remote_target::getpkt_pipelined_reply ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  int packet_len = getpkt (&rs->buf);
+  if (packet_len < 0)
     {
-      if (*p != 'b')
-	return TARGET_XFER_E_IO;
+      remote_unpush_target (this);
+      throw_error (TARGET_CLOSE_ERROR,
+		   _("Lost the reply to a pipelined read.  "
+		     "Target detached."));
+    }
 
-      /* Adjust for 'b'.  */
-      p++;
-      packet_len--;
-      decoded_bytes = remote_unescape_input ((const gdb_byte *) p,
-					     packet_len, myaddr,
-					     todo_units * unit_size);
+  return packet_len;
+}
+
+/* Read LEN_UNITS units of memory at MEMADDR into MYADDR, sending up to
+   REMOTE_READ_PIPELINE_DEPTH requests of CHUNK_UNITS units each in
+   PACKET_FORMAT before reading the replies back in order.  Only used
+   when the stub supports pipelined reads and acks are disabled.
+
+   Return values are like remote_read_bytes_1's.  Only the leading
+   contiguous part that was read successfully is reported as
+   transferred; the replies to the requests after a failed or short
+   one are still consumed, but their data is dropped.  If a reply
+   cannot be received at all, there is no telling which of the later
+   packets answers which request, so the connection is closed.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_pipelined (CORE_ADDR memaddr,
+					    gdb_byte *myaddr,
+					    ULONGEST len_units,
+					    int unit_size,
+					    ULONGEST chunk_units,
+					    char packet_format,
+					    ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST nrequests = std::min ((ULONGEST) REMOTE_READ_PIPELINE_DEPTH,
+				 (len_units + chunk_units - 1) / chunk_units);
+
+  for (ULONGEST i = 0; i < nrequests; i++)
+    {
+      ULONGEST offset = i * chunk_units;
+      ULONGEST todo_units = std::min (chunk_units, len_units - offset);
+
+      /* Construct "m/x"<memaddr>","<len>".  */
+      char *buffer = rs->buf.data ();
+      *buffer++ = packet_format;
+      buffer += hexnumstr (buffer,
+			   (ULONGEST) remote_address_masked (memaddr + offset));
+      *buffer++ = ',';
+      buffer += hexnumstr (buffer, todo_units);
+      *buffer = '\0';
+      putpkt (rs->buf);
     }
-  else
+
+  ULONGEST done_units = 0;
+  bool stopped = false;
+  bool io_error = false;
+
+  for (ULONGEST i = 0; i < nrequests; i++)
     {
-      /* Reply describes memory byte by byte, each byte encoded as two hex
-	 characters.  */
-      decoded_bytes = hex2bin (p, myaddr, todo_units * unit_size);
+      ULONGEST offset = i * chunk_units;
+      ULONGEST todo_units = std::min (chunk_units, len_units - offset);
+
+      int packet_len = getpkt_pipelined_reply ();
+
+      if (stopped)
+	continue;
+
+      /* If the reply cannot be expanded, read and drop the ones still
+	 in flight before passing the error on.  */
+      try
+	{
+	  packet_len = decompress_reply (packet_len,
+					 REMOTE_COMPRESSED_MEMORY);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  for (ULONGEST j = i + 1; j < nrequests; j++)
+	    getpkt_pipelined_reply ();
+	  throw;
+	}
+
+      int decoded_bytes
+	= decode_memory_read_reply (rs->buf, packet_len, packet_format,
+				    myaddr + offset * unit_size,
+				    todo_units * unit_size);
+      if (decoded_bytes < 0)
+	{
+	  stopped = true;
+	  if (done_units == 0)
+	    io_error = true;
+	  continue;
+	}
+
+      done_units += decoded_bytes / unit_size;
+      if ((ULONGEST) decoded_bytes < todo_units * unit_size)
+	stopped = true;
     }
 
+  if (io_error && done_units == 0)
+    return TARGET_XFER_E_IO;
+
   /* Return what we have.  Let higher layers handle partial reads.  */
-  *xfered_len_units = (ULONGEST) (decoded_bytes / unit_size);
+  *xfered_len_units = done_units;
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
@@ -10759,6 +11060,35 @@ remote_target::read_frame (gdb::char_vector *buf_p)
 
   while (1)
     {
+      /* Copy the run of plain packet data that has already been
+	 received in one go; only the characters that need special
+	 handling go through readchar.  */
+      const unsigned char *data;
+      int avail = serial_peek_buffered (rs->remote_desc, &data);
+      int len = 0;
+
+      while (len < avail
+	     && data[len] != '$' && data[len] != '#' && data[len] != '*')
+	len++;
+
+      if (len > 0)
+	{
+	  while (bc + len >= buf_p->size ())
+	    {
+	      /* Make some more room in the buffer.  */
+	      buf_p->resize (buf_p->size () * 2);
+	      buf = buf_p->data ();
+	    }
+
+	  memcpy (&buf[bc], data, len);
+	  bc += len;
+	  for (int i = 0; i < len; i++)
+	    csum += data[i];
+
+	  serial_skip_buffered (rs->remote_desc, len);
+	  continue;
+	}
+
       c = readchar (remote_timeout);
       switch (c)
 	{
@@ -12233,8 +12563,11 @@ remote_target::remote_read_qxfer (const char *object_name,
 
   rs->buf[0] = '\0';
   packet_len = getpkt (&rs->buf);
-  if (packet_len < 0
-      || m_features.packet_ok (rs->buf, which_packet).status () != PACKET_OK)
+  if (packet_len < 0)
+    return TARGET_XFER_E_IO;
+
+  packet_len = decompress_reply (packet_len, REMOTE_COMPRESSED_QXFER);
+  if (m_features.packet_ok (rs->buf, which_packet).status () != PACKET_OK)
     return TARGET_XFER_E_IO;
 
   if (rs->buf[0] != 'l' && rs->buf[0] != 'm')
@@ -12742,6 +13075,69 @@ cli_packet_command (const char *args, int from_tty)
   send_remote_packet (view, &cb);
 }
 
+/* Names of the remote_compressed_reply_kind values, for printing.  */
+
+static const char *const remote_compressed_reply_kind_names[] =
+{
+  "m/x",
+  "qXfer",
+  "vFile:pread",
+};
+
+static_assert (ARRAY_SIZE (remote_compressed_reply_kind_names)
+	       == REMOTE_COMPRESSED_MAX);
+
+/* Entry point for the 'maint print remote-compression-stats'
+   command.  */
+
+static void
+maint_print_remote_compression_stats (const char *args, int from_tty)
+{
+  remote_target *remote = get_current_remote_target ();
+
+  if (remote == nullptr)
+    error (_("No remote target."));
+
+  remote_state *rs = remote->get_remote_state ();
+
+  gdb_printf ("%-12s %10s %10s %14s %14s\n", _("Packet"), _("Replies"),
+	      _("Compressed"), _("Wire bytes"), _("Payload bytes"));
+  for (int i = 0; i < REMOTE_COMPRESSED_MAX; i++)
+    {
+      const remote_compression_stats &stats = rs->compression_stats[i];
+
+      gdb_printf ("%-12s %10s %10s %14s %14s\n",
+		  remote_compressed_reply_kind_names[i],
+		  pulongest (stats.replies),
+		  pulongest (stats.compressed_replies),
+		  pulongest (stats.wire_bytes),
+		  pulongest (stats.payload_bytes));
+    }
+}
+
+/* Entry point for the 'maint print remote-hostio-stats' command.  */
+
+static void
+maint_print_remote_hostio_stats (const char *args, int from_tty)
+{
+  remote_target *remote = get_current_remote_target ();
+
+  if (remote == nullptr)
+    error (_("No remote target."));
+
+  const readahead_cache &cache = remote->get_remote_state ()->readahead_cache;
+
+  gdb_printf (_("vFile:pread requests: %s\n"),
+	      pulongest (cache.pread_requests));
+  gdb_printf (_("Round trips: %s\n"), pulongest (cache.round_trips));
+  gdb_printf (_("Bytes read: %s\n"), pulongest (cache.bytes_read));
+  gdb_printf (_("Readahead cache hits: %s\n"),
+	      pulongest (cache.hit_count));
+  gdb_printf (_("Readahead cache misses: %s\n"),
+	      pulongest (cache.miss_count));
+  gdb_printf (_("Readahead window: %s\n"), pulongest (cache.window));
+}
+
 /* Implement 'maint test-remote-args' command.
 
    Treat ARGS as an argument string.  Split the remote arguments using
@@ -13281,8 +13677,6 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
 					   int *attachment_len)
 {
   struct remote_state *rs = get_remote_state ();
-  int ret, bytes_read;
-  const char *attachment_tmp;
 
   if (m_features.packet_support (which_packet) == PACKET_DISABLE)
     {
@@ -13291,7 +13685,28 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
     }
 
   putpkt_binary (rs->buf.data (), command_bytes);
-  bytes_read = getpkt (&rs->buf);
+  return remote_hostio_read_reply (which_packet, remote_errno, attachment,
+				   attachment_len);
+}
+
+/* Read and parse the reply to a host I/O request of type WHICH_PACKET
+   that was already sent to the remote target.  PIPELINED is true if
+   other requests may have been sent after it; see
+   getpkt_pipelined_reply.  Return values are as for
+   remote_hostio_send_command.  */
+
+int
+remote_target::remote_hostio_read_reply (int which_packet,
+					 fileio_error *remote_errno,
+					 const char **attachment,
+					 int *attachment_len,
+					 bool pipelined)
+{
+  struct remote_state *rs = get_remote_state ();
+  int ret, bytes_read;
+  const char *attachment_tmp;
+
+  bytes_read = pipelined ? getpkt_pipelined_reply () : getpkt (&rs->buf);
 
   /* If it timed out, something is wrong.  Don't try to parse the
      buffer.  */
@@ -13301,6 +13716,9 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
       return -1;
     }
 
+  if (which_packet == PACKET_vFile_pread)
+    bytes_read = decompress_reply (bytes_read, REMOTE_COMPRESSED_VFILE_PREAD);
+
   switch (m_features.packet_ok (rs->buf, which_packet).status ())
     {
     case PACKET_ERROR:
@@ -13492,19 +13910,15 @@ remote_target::fileio_pwrite (int fd, const gdb_byte *write_buf, int len,
   return remote_hostio_pwrite (fd, write_buf, len, offset, remote_errno);
 }
 
-/* Helper for the implementation of to_fileio_pread.  Read the file
-   from the remote side with vFile:pread.  */
+/* Send a vFile:pread request for LEN bytes of file FD at OFFSET,
+   without waiting for the reply.  */
 
-int
-remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
-					  ULONGEST offset, fileio_error *remote_errno)
+void
+remote_target::remote_hostio_send_pread (int fd, int len, ULONGEST offset)
 {
   struct remote_state *rs = get_remote_state ();
   char *p = rs->buf.data ();
-  const char *attachment;
   int left = get_remote_packet_size ();
-  int ret, attachment_len;
-  int read_len;
 
   remote_buffer_add_string (&p, &left, "vFile:pread:");
 
@@ -13516,9 +13930,27 @@ remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 
   remote_buffer_add_int (&p, &left, offset);
 
-  ret = remote_hostio_send_command (p - rs->buf.data (), PACKET_vFile_pread,
-				    remote_errno, &attachment,
-				    &attachment_len);
+  putpkt_binary (rs->buf.data (), p - rs->buf.data ());
+  rs->readahead_cache.pread_requests++;
+}
+
+/* Read the reply to a vFile:pread request for LEN bytes into
+   READ_BUF.  PIPELINED is as for remote_hostio_read_reply.  Return the
+   number of bytes read, 0 at end of file, or -1 on error, setting
+   *REMOTE_ERRNO.  */
+
+int
+remote_target::remote_hostio_read_pread_reply (gdb_byte *read_buf, int len,
+					       fileio_error *remote_errno,
+					       bool pipelined)
+{
+  struct remote_state *rs = get_remote_state ();
+  const char *attachment;
+  int ret, attachment_len;
+  int read_len;
+
+  ret = remote_hostio_read_reply (PACKET_vFile_pread, remote_errno,
+				  &attachment, &attachment_len, pipelined);
 
   if (ret < 0)
     return ret;
@@ -13528,9 +13960,120 @@ remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
   if (read_len != ret)
     error (_("Read returned %d, but %d bytes."), ret, (int) read_len);
 
+  rs->readahead_cache.bytes_read += ret;
   return ret;
 }
 
+/* Helper for the implementation of to_fileio_pread.  Read the file
+   from the remote side with vFile:pread.  */
+
+int
+remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
+					  ULONGEST offset, fileio_error *remote_errno)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (m_features.packet_support (PACKET_vFile_pread) == PACKET_DISABLE)
+    {
+      *remote_errno = FILEIO_ENOSYS;
+      return -1;
+    }
+
+  remote_hostio_send_pread (fd, len, offset);
+  rs->readahead_cache.round_trips++;
+  return remote_hostio_read_pread_reply (read_buf, len, remote_errno);
+}
+
+/* Like remote_hostio_pread_vFile, but read LEN bytes, which may span
+   many packets, keeping up to REMOTE_READ_PIPELINE_DEPTH vFile:pread
+   requests in flight.  Only used when the stub supports pipelined
+   reads and acks are disabled.  The stub may return less data than
+   requested in each reply; the missing parts are requested again.
+   Return the number of contiguous bytes read at OFFSET, which is
+   short only at end of file or on error, 0 at end of file, or -1 if
+   the first part could not be read, setting *REMOTE_ERRNO.  */
+
+int
+remote_target::remote_hostio_pread_pipelined (int fd, gdb_byte *read_buf,
+					      int len, ULONGEST offset,
+					      fileio_error *remote_errno)
+{
+  struct remote_state *rs = get_remote_state ();
+  int chunk = get_remote_packet_size ();
+
+  /* Parts of READ_BUF still to request, as (start, length) pairs, and
+     parts requested whose replies are still to come, in the order
+     the requests were sent.  */
+  std::deque<std::pair<int, int>> todo;
+  std::deque<std::pair<int, int>> in_flight;
+
+  for (int start = 0; start < len; start += chunk)
+    todo.emplace_back (start, std::min (chunk, len - start));
+
+  /* Data at or past LIMIT is unusable, because of an earlier end of
+     file or error.  */
+  int limit = len;
+  bool failed = false;
+
+  while (!todo.empty () || !in_flight.empty ())
+    {
+      if (in_flight.empty ())
+	rs->readahead_cache.round_trips++;
+
+      while (!todo.empty ()
+	     && in_flight.size () < REMOTE_READ_PIPELINE_DEPTH)
+	{
+	  std::pair<int, int> part = todo.front ();
+	  todo.pop_front ();
+	  if (part.first >= limit)
+	    continue;
+
+	  remote_hostio_send_pread (fd, part.second, offset + part.first);
+	  in_flight.push_back (part);
+	}
+
+      if (in_flight.empty ())
+	break;
+
+      std::pair<int, int> part = in_flight.front ();
+      in_flight.pop_front ();
+
+      /* Replies are consumed even past LIMIT, to keep in sync with
+	 the stub.  If a reply cannot be parsed, the ones still in
+	 flight are read and dropped before the error is passed on.  */
+      fileio_error part_errno;
+      int n;
+      try
+	{
+	  n = remote_hostio_read_pread_reply (read_buf + part.first,
+					      part.second, &part_errno, true);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  if (ex.error != TARGET_CLOSE_ERROR)
+	    for (size_t i = 0; i < in_flight.size (); i++)
+	      getpkt_pipelined_reply ();
+	  throw;
+	}
+      if (n <= 0)
+	{
+	  if (part.first < limit)
+	    {
+	      limit = part.first;
+	      failed = n < 0;
+	      *remote_errno = part_errno;
+	    }
+	}
+      else if (n < part.second)
+	todo.emplace_front (part.first + n, part.second - n);
+    }
+
+  if (limit == 0 && failed)
+    return -1;
+
+  return limit;
+}
+
 /* See declaration.h.  */
 
 int
@@ -13553,6 +14096,11 @@ readahead_cache::pread (int fd, gdb_byte *read_buf, size_t len,
   return 0;
 }
 
+/* The maximum number of bytes the vFile:pread readahead cache reads
+   at once.  */
+
+#define REMOTE_HOSTIO_READAHEAD_MAX (1024 * 1024)
+
 /* Implementation of to_fileio_pread.  */
 
 int
@@ -13578,13 +14126,42 @@ remote_target::remote_hostio_pread (int fd, gdb_byte *read_buf, int len,
   remote_debug_printf ("readahead cache miss %s",
 		       pulongest (cache->miss_count));
 
+  /* If several requests can be in flight, read ahead more than a
+     packet's worth, doubling the window each time a miss continues
+     where the previous window ended, and starting over from a single
+     packet on random access.  Without pipelining, a larger window
+     would only cost more round trips for data that may never be
+     needed.  */
+  size_t packet_size = get_remote_packet_size ();
+  bool pipelined
+    = (rs->noack_mode
+       && m_features.packet_support (PACKET_pipelined_reads) == PACKET_ENABLE
+       && m_features.packet_support (PACKET_vFile_pread) == PACKET_ENABLE);
+  if (pipelined
+      && cache->fd == fd
+      && offset == cache->offset + cache->buf.size ())
+    cache->window = std::min (cache->window * 2,
+			      (size_t) REMOTE_HOSTIO_READAHEAD_MAX);
+  else
+    cache->window = packet_size;
+
+  size_t window = cache->window;
+  if (pipelined && len > window)
+    window = std::min ((size_t) len, (size_t) REMOTE_HOSTIO_READAHEAD_MAX);
+  window = std::max (window, packet_size);
+
   cache->fd = fd;
   cache->offset = offset;
-  cache->buf.resize (get_remote_packet_size ());
+  cache->buf.resize (window);
 
-  ret = remote_hostio_pread_vFile (cache->fd, &cache->buf[0],
-				   cache->buf.size (),
-				   cache->offset, remote_errno);
+  if (window > packet_size)
+    ret = remote_hostio_pread_pipelined (cache->fd, &cache->buf[0],
+					 cache->buf.size (),
+					 cache->offset, remote_errno);
+  else
+    ret = remote_hostio_pread_vFile (cache->fd, &cache->buf[0],
+				     cache->buf.size (),
+				     cache->offset, remote_errno);
   if (ret <= 0)
     {
       cache->invalidate_fd (fd);
@@ -16749,6 +17326,23 @@ response packet.  GDB supplies the initial `$' character, and the\n\
 terminating `#' character and checksum."),
 	   &maintenancelist);
 
+  add_cmd ("remote-compression-stats", class_maintenance,
+	   maint_print_remote_compression_stats, _("\
+Print statistics about compressed remote replies.\n\
+For each kind of bulk transfer request whose replies the remote stub\n\
+may compress, print the number of replies received, how many of them\n\
+were compressed, and the number of bytes received before and after\n\
+decompression."),
+	   &maintenanceprintlist);
+
+  add_cmd ("remote-hostio-stats", class_maintenance,
+	   maint_print_remote_hostio_stats, _("\
+Print statistics about remote file reads.\n\
+Print the number of vFile:pread requests sent, the number of round\n\
+trips they took, the number of bytes read, and the state of the\n\
+readahead cache."),
+	   &maintenanceprintlist);
+
   set_show_commands remotebreak_cmds
     = add_setshow_boolean_cmd ("remotebreak", no_class, &remote_break, _("\
 Set whether to send break if interrupted."), _("\
@@ -17093,6 +17687,12 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_multi_wp_addr,
 			 "multi-wp-addr", "multiple-watchpoint-addresses", 0);
 
+  add_packet_config_cmd (PACKET_pipelined_reads, "pipelined-reads",
+			 "pipelined-reads", 0);
+
+  add_packet_config_cmd (PACKET_zlib_compression, "zlib-compression",
+			 "zlib-compression", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
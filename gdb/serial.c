@@ -397,6 +397,43 @@ serial_readchar (struct serial *scb, int timeout)
   return (ch);
 }
 
+int
+serial_peek_buffered (struct serial *scb, const unsigned char **data)
+{
+  if (scb->bufcnt <= 0)
+    return 0;
+
+  *data = scb->bufp;
+  return scb->bufcnt;
+}
+
+void
+serial_skip_buffered (struct serial *scb, int count)
+{
+  gdb_assert (count >= 0 && count <= scb->bufcnt);
+
+  if (serial_logfp != NULL)
+    {
+      for (int c = 0; c < count; c++)
+	serial_logchar (serial_logfp, 'r', scb->bufp[c], 0);
+
+      gdb_flush (serial_logfp);
+    }
+  if (serial_debug_p (scb))
+    {
+      for (int c = 0; c < count; c++)
+	{
+	  gdb_printf (gdb_stdlog, "[");
+	  serial_logchar (gdb_stdlog, 'r', scb->bufp[c], 0);
+	  gdb_printf (gdb_stdlog, "]");
+	}
+      gdb_flush (gdb_stdlog);
+    }
+
+  scb->bufp += count;
+  scb->bufcnt -= count;
+}
+
 void
 serial_write (struct serial *scb, const void *buf, size_t count)
 {
@@ -119,6 +119,22 @@ enum serial_rc {
 
 extern int serial_readchar (struct serial *scb, int timeout);
 
+/* Point *DATA at the input that has already been received from SCB
+   but not read yet, and return its length.  Returns 0 if there is
+   none (or if SCB does not buffer its input), without waiting.  This
+   lets callers scan and copy input in bulk, instead of with one
+   serial_readchar call per character.  The data stays unread until
+   consumed with serial_skip_buffered.  */
+
+extern int serial_peek_buffered (struct serial *scb,
+				 const unsigned char **data);
+
+/* Consume the first COUNT characters of the input returned by
+   serial_peek_buffered, as if they had been read with
+   serial_readchar.  */
+
+extern void serial_skip_buffered (struct serial *scb, int count);
+
 /* Write COUNT bytes from BUF to the port SCB.  Throws exception on
    error.  */
 
@@ -194,6 +194,9 @@ struct rocm_solib_ops : public solib_ops
   bool keep_data_in_core (CORE_ADDR vaddr, unsigned long size) const override
   { return m_host_ops->keep_data_in_core (vaddr, size); }
 
+  void core_file_memory_ranges (std::vector<mem_range> &ranges) const override
+  { return m_host_ops->core_file_memory_ranges (ranges); }
+
   void update_breakpoints () const override
   { return m_host_ops->update_breakpoints (); }
 
@@ -45,6 +45,7 @@
 #include "gdb_bfd.h"
 #include "probe.h"
 
+#include "gdbsupport/unordered_set.h"
 #include <map>
 
 static void svr4_relocate_main_executable (void);
@@ -966,6 +967,55 @@ svr4_solib_ops::keep_data_in_core (CORE_ADDR vaddr, unsigned long size) const
 
 /* See solib.h.  */
 
+void
+svr4_solib_ops::core_file_memory_ranges (std::vector<mem_range> &ranges) const
+{
+  svr4_info *info = get_svr4_info (current_program_space);
+  CORE_ADDR debug_base = this->default_debug_base (info);
+
+  if (debug_base == 0)
+    return;
+
+  link_map_offsets *lmo = this->fetch_link_map_offsets ();
+  int ptr_size
+    = builtin_type (current_inferior ()->arch ())->builtin_data_ptr->length ();
+
+  /* The DT_DEBUG entry, through which the default namespace's r_debug
+     is found.  */
+  CORE_ADDR dyn_ptr_addr;
+  if (gdb_bfd_scan_elf_dyntag (DT_DEBUG, current_program_space->exec_bfd (),
+			       nullptr, &dyn_ptr_addr))
+    ranges.emplace_back (dyn_ptr_addr, ptr_size);
+
+  /* Then, for each namespace, its r_debug, and the link map entries and
+     names of its libraries.  Guard against cycles in corrupted
+     lists.  */
+  gdb::unordered_set<CORE_ADDR> seen;
+  int r_debug_size = (std::max (lmo->r_ldsomap_offset, lmo->r_next_offset)
+		      + ptr_size);
+  while (debug_base != 0 && seen.insert (debug_base).second)
+    {
+      ranges.emplace_back (debug_base, r_debug_size);
+
+      for (CORE_ADDR lm = this->read_r_map (debug_base);
+	   lm != 0 && seen.insert (lm).second; )
+	{
+	  lm_info_svr4_up li = this->read_lm_info (lm, debug_base);
+	  if (li == nullptr)
+	    break;
+
+	  ranges.emplace_back (lm, lmo->link_map_size);
+	  if (li->l_name != 0)
+	    ranges.emplace_back (li->l_name, SO_NAME_MAX_PATH_SIZE);
+	  lm = li->l_next;
+	}
+
+      debug_base = this->read_r_next (debug_base);
+    }
+}
+
+/* See solib.h.  */
+
 bool
 svr4_solib_ops::open_symbol_file_object (int from_tty) const
 {
@@ -105,6 +105,7 @@ struct svr4_solib_ops : public solib_ops
   bool in_dynsym_resolve_code (CORE_ADDR pc) const override;
   bool same (const solib &gdb, const solib &inferior) const override;
   bool keep_data_in_core (CORE_ADDR vaddr, unsigned long size) const override;
+  void core_file_memory_ranges (std::vector<mem_range> &ranges) const override;
   void update_breakpoints () const override;
   void handle_event () const override;
   std::optional<CORE_ADDR> find_solib_addr (solib &so) const override;
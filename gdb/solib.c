@@ -1264,6 +1264,17 @@ solib_keep_data_in_core (CORE_ADDR vaddr, unsigned long size)
 
 /* See solib.h.  */
 
+void
+solib_core_file_memory_ranges (std::vector<mem_range> &ranges)
+{
+  const solib_ops *ops = current_program_space->solib_ops ();
+
+  if (ops != nullptr)
+    ops->core_file_memory_ranges (ranges);
+}
+
+/* See solib.h.  */
+
 void
 clear_solib (program_space *pspace)
 {
@@ -24,6 +24,7 @@
 #include "gdbsupport/function-view.h"
 #include "gdbsupport/intrusive_list.h"
 #include "gdbsupport/owning_intrusive_list.h"
+#include "memrange.h"
 #include "symfile-add-flags.h"
 #include "target-section.h"
 
@@ -216,6 +217,14 @@ struct solib_ops
   virtual bool keep_data_in_core (CORE_ADDR vaddr, unsigned long size) const
   { return false; };
 
+  /* Add to RANGES the memory that must be saved in a core file that
+     otherwise holds only part of the inferior's memory, for the list
+     of shared libraries to be read back from it.
+
+     Defaults to no-op.  */
+  virtual void core_file_memory_ranges (std::vector<mem_range> &ranges) const
+  {}
+
   /* Enable or disable optional solib event breakpoints as appropriate.  This
      should be called whenever stop_on_solib_events is changed.
 
@@ -343,6 +352,11 @@ extern bool solib_contains_address_p (const solib &, CORE_ADDR);
 
 extern bool solib_keep_data_in_core (CORE_ADDR vaddr, unsigned long size);
 
+/* Add to RANGES the memory that must be saved in a partial core file
+   for the list of shared libraries to be read back from it.  */
+
+extern void solib_core_file_memory_ranges (std::vector<mem_range> &ranges);
+
 /* Return true if PC lies in the dynamic symbol resolution code of the
    run time loader.  */
 
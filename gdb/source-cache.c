@@ -24,6 +24,9 @@
 #include "objfiles.h"
 #include "exec.h"
 #include "cli/cli-cmds.h"
+#include "observable.h"
+#include "run-on-main-thread.h"
+#include "gdbsupport/thread-pool.h"
 
 #ifdef HAVE_SOURCE_HIGHLIGHT
 /* If Gnulib redirects 'open' and 'close' to its replacements
@@ -38,6 +41,10 @@
 #include <srchilite/settings.h>
 #endif
 
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
 #if GDB_SELF_TEST
 #include "gdbsupport/selftest.h"
 #endif
@@ -46,6 +53,15 @@
 
 #define MAX_ENTRIES 5
 
+/* Source files at least this large are highlighted in the background,
+   so that their plain text can be shown meanwhile.  */
+
+#define BACKGROUND_HIGHLIGHT_MIN_SIZE (128 * 1024)
+
+/* How often a cached file's modification time is checked.  */
+
+static constexpr std::chrono::seconds MTIME_CHECK_INTERVAL (1);
+
 /* See source-cache.h.  */
 
 source_cache g_source_cache;
@@ -94,7 +110,8 @@ set_use_gnu_source_highlight_enabled (const char *ignore_args,
 
 std::string
 source_cache::get_plain_source_lines (struct symtab *s,
-				      const std::string &fullname)
+				      const std::string &fullname,
+				      time_t *mtime_out)
 {
   scoped_fd desc (open_source_file (s));
   if (desc.get () < 0)
@@ -118,6 +135,7 @@ source_cache::get_plain_source_lines (struct symtab *s,
 
   if (mtime && mtime < st.st_mtime)
     warning (_("Source file is more recent than executable."));
+  *mtime_out = st.st_mtime;
 
   std::vector<off_t> offsets;
   offsets.push_back (0);
@@ -194,18 +212,25 @@ get_language_name (enum language lang)
 
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 
-/* Try to highlight CONTENTS from file FULLNAME in language LANG using
-   the GNU source-highlight library.  Return true if highlighting
-   succeeded.  */
+#if CXX_STD_THREAD
+/* Serializes the uses of the GNU source-highlight library, which may
+   happen on worker threads.  */
+static std::mutex source_highlight_lock;
+#endif
+
+/* Highlight CONTENTS from file FULLNAME in language LANG using the GNU
+   source-highlight library.  Return true if highlighting succeeded.
+   This may be called on a worker thread.  */
 
 static bool
-try_source_highlight (std::string &contents ATTRIBUTE_UNUSED,
-		      enum language lang ATTRIBUTE_UNUSED,
-		      const std::string &fullname ATTRIBUTE_UNUSED)
+source_highlight (std::string &contents ATTRIBUTE_UNUSED,
+		  enum language lang ATTRIBUTE_UNUSED,
+		  const std::string &fullname ATTRIBUTE_UNUSED)
 {
 #ifdef HAVE_SOURCE_HIGHLIGHT
-  if (!use_gnu_source_highlight)
-    return false;
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (source_highlight_lock);
+#endif
 
   const char *lang_name = get_language_name (lang);
 
@@ -260,6 +285,20 @@ try_source_highlight (std::string &contents ATTRIBUTE_UNUSED,
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 }
 
+/* Try to highlight CONTENTS from file FULLNAME in language LANG using
+   the GNU source-highlight library, if its use is enabled.  Return
+   true if highlighting succeeded.  */
+
+static bool
+try_source_highlight (std::string &contents, enum language lang,
+		      const std::string &fullname)
+{
+  if (!use_gnu_source_highlight)
+    return false;
+
+  return source_highlight (contents, lang, fullname);
+}
+
 #ifdef HAVE_SOURCE_HIGHLIGHT
 #if GDB_SELF_TEST
 namespace selftests
@@ -319,6 +358,24 @@ source_cache::ensure (struct symtab *s)
 	     when reading the file.  */
 	  gdb_assert (m_offset_cache.find (fullname)
 		      != m_offset_cache.end ());
+
+	  /* If the file changed since it was read, read it again.  This
+	     is called for every line the TUI shows, so don't stat the
+	     file every time.  */
+	  auto now = std::chrono::steady_clock::now ();
+	  if (now - m_source_map[i].mtime_checked >= MTIME_CHECK_INTERVAL)
+	    {
+	      struct stat st;
+	      m_source_map[i].mtime_checked = now;
+	      if (stat (fullname.c_str (), &st) == 0
+		  && st.st_mtime != m_source_map[i].mtime)
+		{
+		  m_offset_cache.erase (fullname);
+		  m_source_map.erase (m_source_map.begin () + i);
+		  break;
+		}
+	    }
+
 	  /* Not strictly LRU, but at least ensure that the most
 	     recently used entry is always the last candidate for
 	     deletion.  Note that this property is relied upon by at
@@ -328,9 +385,12 @@ source_cache::ensure (struct symtab *s)
 
 	  /* If the styling status of the cached entry matches our desired
 	     styling status, or we know this file cannot be styled, in
-	     which case, this (unstyled) content, is the best we can do.  */
-	  if (((source_styling && gdb_stdout->can_emit_style_escape ())
-	       == m_source_map[size - 1].styled)
+	     which case, this (unstyled) content, is the best we can do.
+	     Likewise while the content is being styled.  */
+	  bool want_styled = (source_styling
+			      && gdb_stdout->can_emit_style_escape ());
+	  if (want_styled == m_source_map[size - 1].styled
+	      || (want_styled && m_source_map[size - 1].styling_ticket != 0)
 	      || m_no_styling_files.count (fullname) > 0)
 	    return true;
 
@@ -344,10 +404,12 @@ source_cache::ensure (struct symtab *s)
     }
 
   std::string contents;
+  time_t mtime;
   bool styled_p = false;
+  unsigned int styling_ticket = 0;
   try
     {
-      contents = get_plain_source_lines (s, fullname);
+      contents = get_plain_source_lines (s, fullname, &mtime);
     }
   catch (const gdb_exception_error &e)
     {
@@ -356,6 +418,13 @@ source_cache::ensure (struct symtab *s)
     }
 
   if (source_styling && gdb_stdout->can_emit_style_escape ()
+      && m_no_styling_files.count (fullname) == 0
+      && contents.size () >= BACKGROUND_HIGHLIGHT_MIN_SIZE)
+    styling_ticket = highlight_in_background (fullname, contents,
+					      s->language ());
+
+  if (styling_ticket == 0
+      && source_styling && gdb_stdout->can_emit_style_escape ()
       && m_no_styling_files.count (fullname) == 0)
     {
       styled_p
@@ -391,7 +460,8 @@ source_cache::ensure (struct symtab *s)
     }
 
   source_text result
-    = { std::move (fullname), std::move (contents), styled_p };
+    = { std::move (fullname), std::move (contents), styled_p, mtime,
+	std::chrono::steady_clock::now (), styling_ticket };
   m_source_map.push_back (std::move (result));
 
   if (m_source_map.size () > MAX_ENTRIES)
@@ -406,6 +476,90 @@ source_cache::ensure (struct symtab *s)
 
 /* See source-cache.h.  */
 
+unsigned int
+source_cache::highlight_in_background (const std::string &fullname,
+				       const std::string &contents,
+				       enum language lang)
+{
+  /* Without worker threads there is nothing to gain.  The extension
+     languages must be called on the main thread, as they may use any
+     part of GDB, so only the GNU source-highlight library can be used
+     in the background; if it is not used, the extension languages are
+     called once the current command completes.  */
+  if (gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return 0;
+
+  unsigned int ticket = ++m_last_styling_ticket;
+  if (ticket == 0)
+    ticket = ++m_last_styling_ticket;
+
+  if (!use_gnu_source_highlight)
+    {
+      run_on_main_thread ([=] ()
+	{
+	  g_source_cache.highlight_done (fullname, ticket, {}, false, lang);
+	});
+      return ticket;
+    }
+
+  gdb::thread_pool::g_thread_pool->post_task ([=, text = contents] () mutable
+    {
+      bool styled = source_highlight (text, lang, fullname);
+      if (!styled)
+	text.clear ();
+
+      run_on_main_thread ([=, text = std::move (text)] () mutable
+	{
+	  g_source_cache.highlight_done (fullname, ticket, std::move (text),
+					 styled, lang);
+	});
+    });
+
+  return ticket;
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::highlight_done (const std::string &fullname,
+			      unsigned int ticket, std::string &&contents,
+			      bool styled, enum language lang)
+{
+  auto iter = std::find_if (m_source_map.begin (), m_source_map.end (),
+			    [&] (const source_text &text)
+			    {
+			      return text.styling_ticket == ticket;
+			    });
+
+  /* The entry was dropped from the cache meanwhile.  */
+  if (iter == m_source_map.end ())
+    return;
+
+  iter->styling_ticket = 0;
+
+  if (!styled)
+    {
+      std::optional<std::string> ext_contents
+	= ext_lang_colorize (fullname, iter->contents, lang);
+      if (ext_contents.has_value ())
+	{
+	  contents = std::move (*ext_contents);
+	  styled = true;
+	}
+      else
+	m_no_styling_files.insert (fullname);
+    }
+
+  if (styled)
+    {
+      iter->contents = std::move (contents);
+      iter->styled = true;
+      gdb::observers::styling_changed.notify ();
+    }
+}
+
+/* See source-cache.h.  */
+
 bool
 source_cache::get_line_charpos (struct symtab *s,
 				const std::vector<off_t> **offsets)
@@ -21,6 +21,7 @@
 
 #include "gdbsupport/unordered_map.h"
 #include "gdbsupport/unordered_set.h"
+#include <chrono>
 
 /* This caches two things related to source files.
 
@@ -29,7 +30,11 @@
 
    Highlighting depends on the GNU Source Highlight library.  When not
    available or when highlighting fails for some reason, this cache
-   will instead store the un-highlighted source text.
+   will instead store the un-highlighted source text.  Large files are
+   highlighted in the background: their plain text is cached and
+   returned at first, and replaced with the highlighted text once it
+   is ready.  Entries are dropped when the file's modification time
+   changes; this is checked at most once per second for each entry.
 
    Second, this will cache the file offsets corresponding to the start
    of each line of a source file.  This cache is not size-limited.  */
@@ -69,6 +74,16 @@ class source_cache
     m_no_styling_files.clear ();
   }
 
+  /* Called on the main thread when the background highlighting of
+     FULLNAME, started for the cache entry with TICKET, completes.
+     STYLED is true if the GNU Source Highlight library produced the
+     highlighted CONTENTS; otherwise CONTENTS are unused, and the
+     extension languages are tried.  LANG is the language of the
+     file.  */
+  void highlight_done (const std::string &fullname, unsigned int ticket,
+		       std::string &&contents, bool styled,
+		       enum language lang);
+
 private:
 
   /* One element in the cache.  */
@@ -80,13 +95,30 @@ class source_cache
     std::string contents;
     /* True if CONTENTS are styled.  Otherwise, false.  */
     bool styled;
+    /* The modification time of the file when it was read.  */
+    time_t mtime;
+    /* When MTIME was last compared with the file's.  */
+    std::chrono::steady_clock::time_point mtime_checked;
+    /* If non-zero, CONTENTS are plain and being highlighted in the
+       background; this identifies the highlighting request.  */
+    unsigned int styling_ticket;
   };
 
   /* A helper function for get_source_lines reads a source file.
-     Returns the contents of the file; or throws an exception on
-     error.  This also updates m_offset_cache.  */
+     Returns the contents of the file, and sets *MTIME to its
+     modification time; or throws an exception on error.  This also
+     updates m_offset_cache.  */
   std::string get_plain_source_lines (struct symtab *s,
-				      const std::string &fullname);
+				      const std::string &fullname,
+				      time_t *mtime);
+
+  /* Start highlighting CONTENTS, the text of FULLNAME in language
+     LANG, in the background.  Return the ticket identifying the
+     request, or zero if the text should be highlighted now
+     instead.  */
+  unsigned int highlight_in_background (const std::string &fullname,
+					const std::string &contents,
+					enum language lang);
 
   /* A helper function that the data for the given symtab is entered
      into both caches.  Returns false on error.  */
@@ -101,6 +133,9 @@ class source_cache
 
   /* The list of files where styling failed.  */
   gdb::unordered_set<std::string> m_no_styling_files;
+
+  /* The last ticket handed out by highlight_in_background.  */
+  unsigned int m_last_styling_ticket = 0;
 };
 
 /* The global source cache.  */
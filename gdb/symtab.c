@@ -32,6 +32,7 @@
 #include "expression.h"
 #include "language.h"
 #include "demangle.h"
+#include "demangle-cache.h"
 #include "inferior.h"
 #include "source.h"
 #include "filenames.h"
@@ -919,13 +920,25 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 			    const char *mangled)
 {
   gdb::unique_xmalloc_ptr<char> demangled;
+  enum language language = gsymbol->language ();
+  enum language result_language;
   int i;
 
-  if (gsymbol->language () != language_unknown)
+  /* The same names appear in many objfiles, so see whether this one
+     was demangled already.  */
+  if (demangle_cache_lookup (mangled, language, &result_language,
+			     &demangled))
     {
-      const struct language_defn *lang = language_def (gsymbol->language ());
+      gsymbol->m_language = result_language;
+      return demangled;
+    }
+
+  if (language != language_unknown)
+    {
+      const struct language_defn *lang = language_def (language);
 
       lang->sniff_from_mangled_name (mangled, &demangled);
+      demangle_cache_store (mangled, language, language, demangled.get ());
       return demangled;
     }
 
@@ -937,6 +950,7 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
       if (lang->sniff_from_mangled_name (mangled, &demangled))
 	{
 	  gsymbol->m_language = l;
+	  demangle_cache_store (mangled, language, l, demangled.get ());
 	  return demangled;
 	}
     }
@@ -5956,21 +5970,20 @@ default_collect_symbol_completion_matches_break_on
   if (code == TYPE_CODE_UNDEF)
     {
       for (objfile &objfile : current_program_space->objfiles ())
-	{
-	  for (minimal_symbol *msymbol : objfile.msymbols ())
+	iterate_over_minimal_symbols_for_completion
+	  (&objfile, lookup_name, [&] (minimal_symbol *msymbol)
 	    {
 	      QUIT;
 
 	      if (completion_skip_symbol (mode, msymbol))
-		continue;
+		return;
 
 	      completion_list_add_msymbol (tracker, msymbol, lookup_name,
 					   sym_text, word);
 
 	      completion_list_objc_symbol (tracker, msymbol, lookup_name,
 					   sym_text, word);
-	    }
-	}
+	    });
     }
 
   /* Add completions for all currently loaded symbol tables.  */
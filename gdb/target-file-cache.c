@@ -0,0 +1,269 @@
+/* Local cache of files read from the target.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "target-file-cache.h"
+#include "build-id.h"
+#include "cli/cli-cmds.h"
+#include "command.h"
+#include "event-top.h"
+#include "gdb_bfd.h"
+#include "gdbcore.h"
+#include "gdbsupport/byte-vector.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/fileio.h"
+#include <sys/stat.h>
+
+/* Files read from the target through a "target:" sysroot are copied
+   whole into a local directory the first time they are read, keyed
+   by their build ID.  Later sessions, possibly against another
+   instance of the same target, then read them from the local copy,
+   instead of transferring them again.  */
+
+/* When true, show debug messages about the target file cache.  */
+static bool debug_target_file_cache = false;
+
+#define target_file_cache_debug_printf(fmt, ...) \
+  debug_prefixed_printf_cond (debug_target_file_cache, "target-file-cache", \
+			      fmt, ##__VA_ARGS__)
+
+/* Whether the target file cache is enabled, for "set/show
+   target-file-cache enabled".  */
+static bool target_file_cache_enabled = false;
+
+/* The cache directory, for "set/show target-file-cache directory".  */
+static std::string target_file_cache_directory;
+
+/* The size of the reads used to copy a file from the target.  Reading
+   in large windows lets the target layer batch the transfer.  */
+#define TARGET_FILE_CACHE_FETCH_SIZE (1024 * 1024)
+
+/* set/show target-file-cache commands.  */
+static cmd_list_element *set_target_file_cache_list;
+static cmd_list_element *show_target_file_cache_list;
+
+/* See target-file-cache.h.  */
+
+bool
+target_file_cache_enabled_p ()
+{
+  return target_file_cache_enabled && !target_file_cache_directory.empty ();
+}
+
+/* Copy the SIZE bytes of the target file open as FD to the local file
+   PATH.  Return true on success.  */
+
+static bool
+fetch_target_file (target_fd fd, ULONGEST size, const std::string &path)
+{
+  std::string dir = ldirname (path.c_str ());
+  if (!mkdir_recursive (dir.c_str ()))
+    {
+      target_file_cache_debug_printf ("could not create %s: %s",
+				      dir.c_str (), safe_strerror (errno));
+      return false;
+    }
+
+  gdb::char_vector temp_path = make_temp_filename (path);
+  scoped_fd temp_fd = gdb_mkostemp_cloexec (temp_path.data (), O_BINARY);
+  if (temp_fd.get () == -1)
+    {
+      target_file_cache_debug_printf ("could not create %s: %s",
+				      temp_path.data (),
+				      safe_strerror (errno));
+      return false;
+    }
+  gdb::unlinker unlink_temp (temp_path.data ());
+
+  gdb::byte_vector buf (std::min<ULONGEST> (size,
+					    TARGET_FILE_CACHE_FETCH_SIZE));
+  ULONGEST offset = 0;
+  while (offset < size)
+    {
+      QUIT;
+
+      int len = std::min<ULONGEST> (size - offset, buf.size ());
+      fileio_error target_errno;
+      int n = target_fileio_pread (fd, buf.data (), len, offset,
+				   &target_errno);
+      if (n <= 0)
+	{
+	  target_file_cache_debug_printf ("reading at offset %s failed",
+					  pulongest (offset));
+	  return false;
+	}
+
+      for (int done = 0; done < n; )
+	{
+	  ssize_t written = write (temp_fd.get (), buf.data () + done,
+				   n - done);
+	  if (written < 0)
+	    {
+	      target_file_cache_debug_printf ("could not write %s: %s",
+					      temp_path.data (),
+					      safe_strerror (errno));
+	      return false;
+	    }
+	  done += written;
+	}
+
+      offset += n;
+    }
+
+  if (close (temp_fd.release ()) != 0
+      || rename (temp_path.data (), path.c_str ()) != 0)
+    {
+      target_file_cache_debug_printf ("could not store %s: %s",
+				      path.c_str (), safe_strerror (errno));
+      return false;
+    }
+
+  unlink_temp.keep ();
+  return true;
+}
+
+/* Return true if the local file PATH is a valid cached copy of a
+   target file whose build ID is BUILD_ID and whose size is SIZE.  The
+   build ID of the copy is checked as well as its size, so that a copy
+   that was truncated, modified or replaced behind GDB's back is
+   fetched again rather than used.  */
+
+static bool
+cached_copy_valid_p (const std::string &path, const bfd_build_id *build_id,
+		     ULONGEST size)
+{
+  struct stat st;
+  if (stat (path.c_str (), &st) != 0)
+    return false;
+
+  if ((ULONGEST) st.st_size != size)
+    {
+      target_file_cache_debug_printf ("%s has the wrong size",
+				      path.c_str ());
+      return false;
+    }
+
+  gdb_bfd_ref_ptr abfd = gdb_bfd_open (path.c_str (), gnutarget);
+  if (abfd == nullptr || !bfd_check_format (abfd.get (), bfd_object))
+    {
+      target_file_cache_debug_printf ("%s is not an object file",
+				      path.c_str ());
+      return false;
+    }
+
+  const bfd_build_id *local_id = build_id_bfd_get (abfd.get ());
+  if (local_id == nullptr
+      || !build_id_equal (local_id, build_id))
+    {
+      target_file_cache_debug_printf ("%s has a different build ID",
+				      path.c_str ());
+      return false;
+    }
+
+  return true;
+}
+
+/* See target-file-cache.h.  */
+
+scoped_fd
+target_file_cache_open (const char *filename, target_fd fd,
+			const bfd_build_id *build_id, ULONGEST size)
+{
+  if (!target_file_cache_enabled_p ())
+    return scoped_fd (-1);
+
+  /* A stripped file and its separate debug file share the build ID,
+     so the file name is part of the key too.  */
+  std::string path = string_printf ("%s/%s/%s",
+				    target_file_cache_directory.c_str (),
+				    build_id_to_string (build_id).c_str (),
+				    lbasename (filename));
+
+  if (cached_copy_valid_p (path, build_id, size))
+    target_file_cache_debug_printf ("using cached copy %s of %s",
+				    path.c_str (), filename);
+  else
+    {
+      target_file_cache_debug_printf ("copying %s (%s bytes) to %s",
+				      filename, pulongest (size),
+				      path.c_str ());
+      if (!fetch_target_file (fd, size, path))
+	return scoped_fd (-1);
+    }
+
+  scoped_fd local_fd = gdb_open_cloexec (path.c_str (), O_RDONLY | O_BINARY,
+					 0);
+  if (local_fd.get () == -1)
+    target_file_cache_debug_printf ("could not open %s: %s",
+				    path.c_str (), safe_strerror (errno));
+
+  return local_fd;
+}
+
+/* "set target-file-cache directory" handler.  */
+
+static void
+set_target_file_cache_directory (const char *arg, int from_tty,
+				 cmd_list_element *c)
+{
+  /* Make sure the directory is absolute and tilde-expanded.  */
+  target_file_cache_directory = gdb_abspath (target_file_cache_directory);
+}
+
+INIT_GDB_FILE (target_file_cache)
+{
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    target_file_cache_directory = cache_dir + "/target-files";
+
+  add_setshow_prefix_cmd ("target-file-cache", class_files,
+			  _("Set target file cache options."),
+			  _("Show target file cache options."),
+			  &set_target_file_cache_list,
+			  &show_target_file_cache_list,
+			  &setlist, &showlist);
+
+  add_setshow_boolean_cmd ("enabled", class_files,
+			   &target_file_cache_enabled, _("\
+Set whether files read from the target are cached locally."), _("\
+Show whether files read from the target are cached locally."), _("\
+When on, object files read through a \"target:\" sysroot are copied\n\
+whole into the target file cache directory, keyed by their build ID,\n\
+and read from there by later sessions instead of from the target."),
+			   nullptr, nullptr,
+			   &set_target_file_cache_list,
+			   &show_target_file_cache_list);
+
+  add_setshow_filename_cmd ("directory", class_files,
+			    &target_file_cache_directory, _("\
+Set the directory of the target file cache."), _("\
+Show the directory of the target file cache."), nullptr,
+			    set_target_file_cache_directory, nullptr,
+			    &set_target_file_cache_list,
+			    &show_target_file_cache_list);
+
+  add_setshow_boolean_cmd ("target-file-cache", class_maintenance,
+			   &debug_target_file_cache, _("\
+Set display of target file cache debug messages."), _("\
+Show display of target file cache debug messages."), _("\
+When on, debugging output for the target file cache is displayed."),
+			   nullptr, nullptr,
+			   &setdebuglist, &showdebuglist);
+}
@@ -0,0 +1,43 @@
+/* Local cache of files read from the target.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDB_TARGET_FILE_CACHE_H
+#define GDB_TARGET_FILE_CACHE_H
+
+#include "gdbsupport/scoped_fd.h"
+#include "target.h"
+
+struct bfd_build_id;
+
+/* Return true if the target file cache is enabled.  */
+
+extern bool target_file_cache_enabled_p ();
+
+/* Return a file descriptor open on a local copy of the target file
+   FILENAME, which is open on the target as FD.  BUILD_ID is the build
+   ID of the file, and SIZE its size in bytes.  If the cache does not
+   hold a copy of the file yet, fetch the whole file from the target
+   into the cache first.  Return an invalid scoped_fd if the cache is
+   disabled, or if no local copy could be made.  */
+
+extern scoped_fd target_file_cache_open (const char *filename, target_fd fd,
+					 const bfd_build_id *build_id,
+					 ULONGEST size);
+
+#endif /* GDB_TARGET_FILE_CACHE_H */
@@ -0,0 +1,47 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* The end of a readable page, followed by an unmapped one.  */
+
+unsigned char *page_end;
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  long size = sysconf (_SC_PAGESIZE);
+  unsigned char *p = mmap (NULL, 2 * size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (p == MAP_FAILED)
+    return 1;
+
+  memset (p, 0, size);
+  munmap (p + size, size);
+  page_end = p + size;
+
+  marker ();	/* Break here.  */
+  return 0;
+}
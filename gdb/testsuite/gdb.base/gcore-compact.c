@@ -0,0 +1,36 @@
+/* Copyright 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Two globals that are not reachable from the stack.  */
+int named_global = 1;
+int other_global = 1;
+
+int
+break_here (int arg)
+{
+  int local = arg * 2;
+
+  return local;		/* break-here */
+}
+
+int
+main (void)
+{
+  named_global = 42;
+  other_global = 42;
+  return break_here (21);
+}
@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This file is compiled without debug info, so these are only known as
+   minimal symbols.  */
+
+int msym_variable = 1;
+
+void
+msym_function_one (void)
+{
+}
+
+void
+msym_function_two (void)
+{
+}
+
+void
+msym_unique_function (void)
+{
+}
+
+int
+main (void)
+{
+  msym_function_one ();
+  msym_function_two ();
+  msym_unique_function ();
+  return msym_variable;
+}
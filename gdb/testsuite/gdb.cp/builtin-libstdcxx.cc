@@ -0,0 +1,57 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static void
+marker ()
+{
+}
+
+int
+main ()
+{
+  std::string empty_string;
+  std::string short_string ("hello");
+  std::string long_string (300, 'x');
+
+  std::vector<int> empty_vector;
+  std::vector<int> small_vector { 1, 2, 3 };
+  small_vector.reserve (8);
+  std::vector<int> large_vector;
+  for (int i = 0; i < 50000; ++i)
+    large_vector.push_back (i);
+  std::vector<std::string> string_vector { "one", "two" };
+  std::vector<std::vector<int>> nested_vector { { 1 }, { 2, 3 } };
+
+  std::deque<int> empty_deque;
+  std::deque<int> small_deque { 1, 2, 3 };
+  small_deque.push_front (0);
+  std::deque<long> large_deque;
+  for (long i = 0; i < 1000; ++i)
+    large_deque.push_back (i);
+
+  std::unordered_map<int, int> empty_map;
+  std::unordered_map<int, int> one_map { { 1, 10 } };
+  std::unordered_map<int, std::string> string_map { { 1, "one" } };
+
+  marker ();
+  return 0;
+}
@@ -0,0 +1,54 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace ourns
+{
+  struct Cluster
+  {
+    static int method_one (int x);
+    static int method_two (int x);
+  };
+
+  int
+  Cluster::method_one (int x)
+  {
+    return x + 1;
+  }
+
+  int
+  Cluster::method_two (int x)
+  {
+    return x + 2;
+  }
+
+  namespace inner
+  {
+    int
+    inner_function ()
+    {
+      return 3;
+    }
+  }
+}
+
+int
+main ()
+{
+  return (ourns::Cluster::method_one (0)
+	  + ourns::Cluster::method_two (0)
+	  + ourns::inner::inner_function ());
+}
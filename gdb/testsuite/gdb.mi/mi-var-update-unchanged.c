@@ -0,0 +1,39 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct point
+{
+  int x;
+  int y;
+  int z[4];
+};
+
+struct point global_point = { 7, 8, { 9, 10, 11, 12 } };
+
+int
+main (void)
+{
+  struct point p = { 1, 2, { 3, 4, 5, 6 } };
+  struct point q = p;
+
+  p.y = 20;	/* First change.  */
+  p.z[2] = 50;	/* Second change.  */
+  global_point.x = 70;	/* Third change.  */
+  q.x = 0;	/* After the changes.  */
+
+  return q.x;
+}
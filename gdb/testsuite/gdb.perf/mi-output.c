@@ -0,0 +1,56 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdio.h>
+
+#define NR_ITEMS 2048
+#define BUFFER_SIZE 65536
+
+struct item
+{
+  int id;
+  double value;
+  char name[24];
+};
+
+unsigned char buffer[BUFFER_SIZE];
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  struct item items[NR_ITEMS];
+  int i;
+
+  for (i = 0; i < NR_ITEMS; i++)
+    {
+      items[i].id = i;
+      items[i].value = i * 0.5;
+      /* The quotes and the tab need escaping in MI output.  */
+      snprintf (items[i].name, sizeof (items[i].name), "item \"%d\"\t", i);
+    }
+
+  for (i = 0; i < BUFFER_SIZE; i++)
+    buffer[i] = i * 7;
+
+  marker ();
+  return items[0].id;
+}
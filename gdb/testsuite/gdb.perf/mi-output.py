@@ -0,0 +1,47 @@
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+import gdb
+
+
+class MiOutput(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, count):
+        super(MiOutput, self).__init__("mi-output")
+        self.count = count
+
+    def _run_mi(self, command, count):
+        for _ in range(0, count):
+            gdb.execute('interpreter-exec mi "%s"' % command, False, True)
+
+    def warm_up(self):
+        self._run_mi("-stack-list-variables --all-values", 1)
+
+    def execute_test(self):
+        # Each command produces a large result record: many small
+        # fields for the memory contents, and long strings needing
+        # escaping for the variables.
+        commands = [
+            ("read-memory", "-data-read-memory-bytes buffer 65536"),
+            ("list-variables", "-stack-list-variables --all-values"),
+            ("evaluate", "-data-evaluate-expression items"),
+        ]
+        for name, command in commands:
+
+            def run(command=command):
+                self._run_mi(command, self.count)
+
+            self.measure.measure(run, name)
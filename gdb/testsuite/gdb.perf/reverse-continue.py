@@ -0,0 +1,36 @@
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+import gdb
+
+
+class ReverseContinue(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self):
+        super(ReverseContinue, self).__init__("reverse-continue")
+
+    def warm_up(self):
+        self._run()
+
+    def _run(self):
+        # Replay the whole log backward, then forward again.
+        gdb.execute("reverse-continue", False, True)
+        gdb.execute("continue", False, True)
+
+    def execute_test(self):
+        for size in (1, 64, 4096, 65536):
+            gdb.execute("set record full replay-batch-size %d" % size)
+            self.measure.measure(lambda: self._run(), size)
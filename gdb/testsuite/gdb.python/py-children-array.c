@@ -0,0 +1,49 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct vec
+{
+  int *start;
+  int *finish;
+};
+
+struct map
+{
+  int *keys;
+  int *values;
+  int count;
+};
+
+int data[100];
+int keys[2] = { 1, 2 };
+int values[2] = { 10, 20 };
+
+int
+main (void)
+{
+  struct vec v = { data, data + 100 };
+  struct vec empty = { 0, 0 };
+  /* The elements of this one can't be read.  */
+  struct vec bad = { (int *) 8, (int *) 8 + 3 };
+  struct map m = { keys, values, 2 };
+  int i;
+
+  for (i = 0; i < 100; ++i)
+    data[i] = i;
+
+  return 0;		/* Break here.  */
+}
@@ -0,0 +1,78 @@
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import gdb
+
+
+class VecPrinter(gdb.ValuePrinter):
+    def __init__(self, val):
+        self.__val = val
+
+    def __count(self):
+        return int(self.__val["finish"] - self.__val["start"])
+
+    def to_string(self):
+        return "vec of %d" % self.__count()
+
+    def display_hint(self):
+        return "array"
+
+    def children_array(self):
+        count = self.__count()
+        if count == 0:
+            return None
+        start = self.__val["start"]
+        return start.dereference().cast(start.type.target().array(count - 1))
+
+    def children(self):
+        # Only used when children_array returns None.  The values differ
+        # from the array's, so that the tests can tell which was used.
+        start = self.__val["start"]
+        for i in range(self.__count()):
+            yield "[%d]" % i, start[i] + 1000
+
+
+class MapPrinter(gdb.ValuePrinter):
+    def __init__(self, val):
+        self.__val = val
+
+    def to_string(self):
+        return "map of %d" % int(self.__val["count"])
+
+    def display_hint(self):
+        return "map"
+
+    def children_array(self):
+        # Must not be used, since the display hint is "map".
+        count = int(self.__val["count"])
+        keys = self.__val["keys"]
+        return keys.dereference().cast(keys.type.target().array(count - 1))
+
+    def children(self):
+        for i in range(int(self.__val["count"])):
+            yield "k%d" % i, self.__val["keys"][i]
+            yield "v%d" % i, self.__val["values"][i]
+
+
+def lookup_printer(val):
+    tag = val.type.strip_typedefs().tag
+    if tag == "vec":
+        return VecPrinter(val)
+    if tag == "map":
+        return MapPrinter(val)
+    return None
+
+
+gdb.pretty_printers.append(lookup_printer)
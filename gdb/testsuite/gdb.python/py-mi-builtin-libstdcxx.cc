@@ -0,0 +1,38 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+int
+main ()
+{
+  std::string str ("hello");
+
+  std::vector<int> vec;
+  for (int i = 0; i < 1000; ++i)
+    vec.push_back (i);
+
+  std::deque<int> deq { 1, 2, 3 };
+  deq.push_front (0);
+
+  std::unordered_map<int, int> map { { 1, 10 } };
+
+  return 0;  /* Break here.  */
+}
@@ -0,0 +1,47 @@
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import gdb
+import gdb.printing
+
+
+class PointPrinter:
+    def __init__(self, val, name):
+        self.val = val
+        self.name = name
+
+    def to_string(self):
+        return "%s(%d, %d)" % (self.name, int(self.val["x"]), int(self.val["y"]))
+
+
+def lookup_point(val):
+    if val.type.strip_typedefs().tag == "point":
+        return PointPrinter(val, "point")
+    return None
+
+
+def lookup_other(val):
+    if val.type.strip_typedefs().tag == "point":
+        return PointPrinter(val, "other")
+    return None
+
+
+def build_collection():
+    pp = gdb.printing.RegexpCollectionPrettyPrinter("pp-cache")
+    pp.add_printer("point", "^point$", lambda val: PointPrinter(val, "collection"))
+    return pp
+
+
+collection = build_collection()
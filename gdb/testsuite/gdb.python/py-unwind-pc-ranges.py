@@ -0,0 +1,59 @@
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests the PC ranges of
+# Python unwinders, and the cache of what the unwinders made of each
+# frame.
+
+import gdb
+from gdb.unwinder import Unwinder
+
+
+class CountingUnwinder(Unwinder):
+    """An unwinder that records the PC of each frame it is called
+    for, and never claims any."""
+
+    def __init__(self):
+        super().__init__("counting")
+        self.pcs = []
+
+    def __call__(self, pending_frame):
+        self.pcs.append(pending_frame.pc())
+        return None
+
+
+def function_range(name):
+    """Return the (start, end) range of the function NAME."""
+    block = gdb.block_for_pc(int(gdb.parse_and_eval("&" + name)))
+    while block.function is None:
+        block = block.superblock
+    return (block.start, block.end)
+
+
+def all_in_range(pcs, pc_range):
+    """Return True if all of PCS are in PC_RANGE."""
+    start, end = pc_range
+    return all(int(start) <= pc < int(end) for pc in pcs)
+
+
+def all_in_objfile(pcs, objfile):
+    """Return True if all of PCS are within the code of OBJFILE."""
+    progspace = gdb.current_progspace()
+    return all(progspace.objfile_for_address(pc) == objfile for pc in pcs)
+
+
+counting_unwinder = CountingUnwinder()
+gdb.unwinder.register_unwinder(None, counting_unwinder, replace=True)
+print("Python script imported")
@@ -199,6 +199,64 @@ write_basic_trace_file (void)
   finish_trace_file (fd);
 }
 
+/* The number of traceframes in the trace file written by
+   write_multi_trace_file.  */
+
+#define MULTI_TRACE_FRAMES 40
+
+void write_error_trace_file (void);
+
+void
+write_multi_trace_file (void)
+{
+  int fd, int_x, i;
+
+  fd = start_trace_file (TFILE_DIR "tfile-multi.tf");
+
+  snprintf (spbuf, sizeof spbuf, "R %x\n", 500 /* FIXME get from arch */);
+  write (fd, spbuf, strlen (spbuf));
+
+  snprintf (spbuf, sizeof spbuf,
+	    "status 0;tstop:0;tframes:%d;tcreated:%d;tfree:100;tsize:1000\n",
+	    MULTI_TRACE_FRAMES, MULTI_TRACE_FRAMES);
+  write (fd, spbuf, strlen (spbuf));
+
+  /* Two tracepoints, whose hits alternate.  */
+  snprintf (spbuf, sizeof spbuf, "tp T1:%llx:E:0:0\n",
+	    (unsigned long long) FUNCTION_ADDRESS (write_basic_trace_file));
+  write (fd, spbuf, strlen (spbuf));
+  snprintf (spbuf, sizeof spbuf, "tp T2:%llx:E:0:0\n",
+	    (unsigned long long) FUNCTION_ADDRESS (write_error_trace_file));
+  write (fd, spbuf, strlen (spbuf));
+
+  write (fd, "\n", 1);
+
+  /* Each traceframe collects testglob, holding the number of the
+     traceframe, so the tests can tell which one is selected.  */
+  trptr = trbuf;
+  for (i = 0; i < MULTI_TRACE_FRAMES; i++)
+    {
+      tfile_write_16 (i % 2 + 1);
+
+      tfsizeptr = trptr;
+      trptr += 4;
+      tfile_write_8 ('M');
+      tfile_write_addr ((char *) &testglob);
+      tfile_write_16 (sizeof (i));
+      tfile_write_buf (&i, sizeof (i));
+      int_x = trptr - tfsizeptr - sizeof (int);
+      memcpy (tfsizeptr, &int_x, 4);
+    }
+
+  /* Write end of tracebuffer marker.  */
+  memset (trptr, 0, 6);
+  trptr += 6;
+
+  write (fd, trbuf, trptr - trbuf);
+
+  finish_trace_file (fd);
+}
+
 /* Convert number NIB to a hex digit.  */
 
 static int
@@ -286,6 +344,8 @@ main (void)
 
   write_error_trace_file ();
 
+  write_multi_trace_file ();
+
   done_making_trace_files ();
 
   return 0;
@@ -422,6 +422,31 @@ static int cur_data_size;
 int trace_regblock_size;
 static std::string trace_tdesc;
 
+/* An entry in the traceframe index of the trace file.  */
+
+struct tfile_frame_index_entry
+{
+  /* Offset in the file of the traceframe's data blocks.  */
+  off_t data_offset;
+
+  /* Size of the traceframe's data blocks.  */
+  unsigned int data_size;
+
+  /* Number (on the target) of the tracepoint that collected this
+     traceframe.  */
+  short tpnum;
+};
+
+/* Index of the traceframes in the trace file, indexed by traceframe
+   number.  This is built by a single pass over the file the first
+   time a traceframe is looked for, so that later searches don't have
+   to scan the file again.  */
+static std::vector<tfile_frame_index_entry> trace_frame_index;
+
+/* True if TRACE_FRAME_INDEX has been built for the current trace
+   file.  */
+static bool trace_frame_index_valid;
+
 static void tfile_append_tdesc_line (const char *line);
 static void tfile_interp_line (const char *line,
 			       struct uploaded_tp **utpp,
@@ -483,6 +508,8 @@ tfile_target_open (const char *arg, int from_tty)
 
   /* Make sure this is clear.  */
   trace_tdesc.clear ();
+  trace_frame_index.clear ();
+  trace_frame_index_valid = false;
 
   bytes = 0;
   /* Read the file header and test for validity.  */
@@ -621,6 +648,8 @@ tfile_target::close ()
   trace_fd = -1;
   trace_filename.reset ();
   trace_tdesc.clear ();
+  trace_frame_index.clear ();
+  trace_frame_index_valid = false;
 
   trace_reset_local_state ();
 }
@@ -638,139 +667,153 @@ tfile_target::get_tracepoint_status (tracepoint *tp, struct uploaded_tp *utp)
      trace files, so nothing to do here.  */
 }
 
-/* Given the position of a traceframe in the file, figure out what
-   address the frame was collected at.  This would normally be the
-   value of a collected PC register, but if not available, we
-   improvise.  */
+/* Given the number of the tracepoint that collected a traceframe,
+   figure out what address the frame was collected at.  This would
+   normally be the value of a collected PC register, but if not
+   available, we improvise.  */
 
 static CORE_ADDR
-tfile_get_traceframe_address (off_t tframe_offset)
+tfile_get_traceframe_address (short tpnum)
 {
   CORE_ADDR addr = 0;
-  short tpnum;
   struct tracepoint *tp;
-  off_t saved_offset = cur_offset;
 
   /* FIXME dig pc out of collected registers.  */
 
   /* Fall back to using tracepoint address.  */
-  lseek (trace_fd, tframe_offset, SEEK_SET);
-  tfile_read ((gdb_byte *) &tpnum, 2);
-  tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					  gdbarch_byte_order
-					    (current_inferior ()->arch ()));
-
   tp = get_tracepoint_by_number_on_target (tpnum);
   /* FIXME this is a poor heuristic if multiple locations.  */
   if (tp != nullptr && tp->has_locations ())
     addr = tp->first_loc ().address;
 
-  /* Restore our seek position.  */
-  cur_offset = saved_offset;
-  lseek (trace_fd, cur_offset, SEEK_SET);
   return addr;
 }
 
-/* Given a type of search and some parameters, scan the collection of
-   traceframes in the file looking for a match.  When found, return
-   both the traceframe and tracepoint number, otherwise -1 for
-   each.  */
+/* Build TRACE_FRAME_INDEX, if not done yet, by walking over the
+   headers of all the traceframes in the file.  */
 
-int
-tfile_target::trace_find (enum trace_find_type type, int num,
-			  CORE_ADDR addr1, CORE_ADDR addr2, int *tpp)
+static void
+tfile_build_frame_index ()
 {
-  short tpnum;
-  int tfnum = 0, found = 0;
-  unsigned int data_size;
-  struct tracepoint *tp;
-  off_t offset, tframe_offset;
-  CORE_ADDR tfaddr;
+  if (trace_frame_index_valid)
+    return;
 
-  if (num == -1)
-    {
-      if (tpp)
-	*tpp = -1;
-      return -1;
-    }
+  bfd_endian byte_order = gdbarch_byte_order (current_inferior ()->arch ());
+  off_t offset = trace_frames_offset;
 
-  lseek (trace_fd, trace_frames_offset, SEEK_SET);
-  offset = trace_frames_offset;
+  trace_frame_index.clear ();
+  lseek (trace_fd, offset, SEEK_SET);
   while (1)
     {
-      tframe_offset = offset;
-      tfile_read ((gdb_byte *) &tpnum, 2);
-      tpnum = (short) extract_signed_integer ((gdb_byte *) &tpnum, 2,
-					      gdbarch_byte_order
-						(current_inferior ()->arch ()));
+      gdb_byte buf[4];
+
+      tfile_read (buf, 2);
       offset += 2;
+      short tpnum = (short) extract_signed_integer (buf, 2, byte_order);
       if (tpnum == 0)
 	break;
-      tfile_read ((gdb_byte *) &data_size, 4);
-      data_size = (unsigned int) extract_unsigned_integer
-				   ((gdb_byte *) &data_size, 4,
-				    gdbarch_byte_order
-				      (current_inferior ()->arch ()));
+
+      tfile_read (buf, 4);
       offset += 4;
+      unsigned int data_size
+	= (unsigned int) extract_unsigned_integer (buf, 4, byte_order);
 
-      if (type == tfind_number)
+      trace_frame_index.push_back ({ offset, data_size, tpnum });
+
+      /* Skip past the traceframe's data.  */
+      lseek (trace_fd, data_size, SEEK_CUR);
+      offset += data_size;
+    }
+
+  trace_frame_index.shrink_to_fit ();
+  trace_frame_index_valid = true;
+}
+
+/* Given a type of search and some parameters, look through the
+   traceframes in the file for a match.  When found, return both the
+   traceframe and tracepoint number, otherwise -1 for each.  */
+
+int
+tfile_target::trace_find (enum trace_find_type type, int num,
+			  CORE_ADDR addr1, CORE_ADDR addr2, int *tpp)
+{
+  struct tracepoint *tp = nullptr;
+  CORE_ADDR tfaddr;
+
+  if (tpp)
+    *tpp = -1;
+
+  if (num == -1)
+    return -1;
+
+  tfile_build_frame_index ();
+
+  int nframes = trace_frame_index.size ();
+  int tfnum;
+
+  if (type == tfind_number)
+    {
+      /* Looking for a specific trace frame.  */
+      if (num < 0 || num >= nframes)
+	return -1;
+      tfnum = num;
+    }
+  else
+    {
+      if (type == tfind_tp)
 	{
-	  /* Looking for a specific trace frame.  */
-	  if (tfnum == num)
-	    found = 1;
+	  tp = get_tracepoint (num);
+	  if (tp == nullptr)
+	    return -1;
 	}
-      else
+
+      /* Start from the _next_ trace frame.  */
+      for (tfnum = std::max (get_traceframe_number () + 1, 0);
+	   tfnum < nframes;
+	   ++tfnum)
 	{
-	  /* Start from the _next_ trace frame.  */
-	  if (tfnum > get_traceframe_number ())
+	  short tpnum = trace_frame_index[tfnum].tpnum;
+	  bool found = false;
+
+	  switch (type)
 	    {
-	      switch (type)
-		{
-		case tfind_pc:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (tfaddr == addr1)
-		    found = 1;
-		  break;
-		case tfind_tp:
-		  tp = get_tracepoint (num);
-		  if (tp && tpnum == tp->number_on_target)
-		    found = 1;
-		  break;
-		case tfind_range:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (addr1 <= tfaddr && tfaddr <= addr2)
-		    found = 1;
-		  break;
-		case tfind_outside:
-		  tfaddr = tfile_get_traceframe_address (tframe_offset);
-		  if (!(addr1 <= tfaddr && tfaddr <= addr2))
-		    found = 1;
-		  break;
-		default:
-		  internal_error (_("unknown tfind type"));
-		}
+	    case tfind_pc:
+	      tfaddr = tfile_get_traceframe_address (tpnum);
+	      found = tfaddr == addr1;
+	      break;
+	    case tfind_tp:
+	      found = tpnum == tp->number_on_target;
+	      break;
+	    case tfind_range:
+	      tfaddr = tfile_get_traceframe_address (tpnum);
+	      found = addr1 <= tfaddr && tfaddr <= addr2;
+	      break;
+	    case tfind_outside:
+	      tfaddr = tfile_get_traceframe_address (tpnum);
+	      found = !(addr1 <= tfaddr && tfaddr <= addr2);
+	      break;
+	    default:
+	      internal_error (_("unknown tfind type"));
 	    }
-	}
-
-      if (found)
-	{
-	  if (tpp)
-	    *tpp = tpnum;
-	  cur_offset = offset;
-	  cur_data_size = data_size;
 
-	  return tfnum;
+	  if (found)
+	    break;
 	}
-      /* Skip past the traceframe's data.  */
-      lseek (trace_fd, data_size, SEEK_CUR);
-      offset += data_size;
-      /* Update our own count of traceframes.  */
-      ++tfnum;
+
+      /* Did not find what we were looking for.  */
+      if (tfnum >= nframes)
+	return -1;
     }
-  /* Did not find what we were looking for.  */
+
+  const tfile_frame_index_entry &entry = trace_frame_index[tfnum];
+
   if (tpp)
-    *tpp = -1;
-  return -1;
+    *tpp = entry.tpnum;
+  cur_offset = entry.data_offset;
+  cur_data_size = entry.data_size;
+  lseek (trace_fd, cur_offset, SEEK_SET);
+
+  return tfnum;
 }
 
 /* Walk over all traceframe block starting at POS offset from
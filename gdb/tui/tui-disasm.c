@@ -107,6 +107,10 @@ tui_disassemble (struct gdbarch *gdbarch,
   /* Must start with an empty list.  */
   asm_lines.clear ();
 
+  /* Fetch the code from the target in blocks, rather than an
+     instruction at a time.  */
+  scoped_disassembly_prefetch prefetch (pc);
+
   /* Now construct each line.  */
   for (int i = 0; i < count; ++i)
     {
@@ -117,7 +121,13 @@ tui_disassemble (struct gdbarch *gdbarch,
 
       try
 	{
-	  pc += gdb_print_insn (gdbarch, pc, stream, NULL);
+	  /* When only the instruction boundaries are wanted, as when
+	     searching backwards, the same instructions are decoded many
+	     times over, so use the cached lengths.  */
+	  if (addr_size == nullptr)
+	    pc += gdb_cached_insn_length (gdbarch, pc);
+	  else
+	    pc += gdb_print_insn (gdbarch, pc, stream, NULL);
 	}
       catch (const gdb_exception_error &except)
 	{
@@ -1157,6 +1157,138 @@ val_print_check_max_depth (struct ui_file *stream, int recurse,
   return false;
 }
 
+/* See valprint.h.  */
+
+void
+print_pretty_children (pretty_children &children,
+		       pretty_children_layout layout, bool print_equals,
+		       struct ui_file *stream, int recurse,
+		       const struct value_print_options *options,
+		       const struct language_defn *language)
+{
+  bool is_map = layout == pretty_children_layout::MAP;
+  bool is_array = layout == pretty_children_layout::ARRAY;
+  bool done = false;
+  bool pretty;
+  unsigned int i;
+
+  /* Use the prettyformat_arrays option if we are printing an array,
+     and the pretty option otherwise.  */
+  if (is_array)
+    pretty = options->prettyformat_arrays;
+  else
+    pretty = (options->prettyformat == Val_prettyformat
+	      || options->prettyformat_structs);
+
+  for (i = 0; i < options->print_max; ++i)
+    {
+      QUIT;
+
+      pretty_child_status status = children.fetch (i);
+      if (status == pretty_child_status::END)
+	{
+	  /* Note that we printed all the available elements.  */
+	  done = true;
+	  break;
+	}
+      else if (status == pretty_child_status::STOP)
+	break;
+      else if (status == pretty_child_status::SKIP)
+	continue;
+
+      /* Print initial "=" to separate the summary and the children.
+	 For other elements, there are three cases:
+	 1. Maps.  Print a "," after each value element.
+	 2. Arrays.  Always print a ",".
+	 3. Other.  Always print a ",".  */
+      if (i == 0)
+	{
+	  if (print_equals)
+	    gdb_puts (" = ", stream);
+	}
+      else if (!is_map || i % 2 == 0)
+	gdb_puts (pretty ? "," : ", ", stream);
+
+      /* Skip printing children if max_depth has been reached.  This check
+	 is performed after the summary and the "=" separator so that
+	 these steps are not skipped if the variable is located within the
+	 permitted depth.  */
+      if (val_print_check_max_depth (stream, recurse, options, language))
+	return;
+      else if (i == 0)
+	/* Print initial "{" to bookend children.  */
+	gdb_puts ("{", stream);
+
+      /* In summary mode, we just want to print "= {...}" if there is
+	 a value.  */
+      if (options->summary)
+	{
+	  /* This increment tricks the post-loop logic to print what
+	     we want.  */
+	  ++i;
+	  /* Likewise.  */
+	  pretty = false;
+	  break;
+	}
+
+      if (!is_map || i % 2 == 0)
+	{
+	  if (pretty)
+	    {
+	      gdb_puts ("\n", stream);
+	      print_spaces (2 + 2 * recurse, stream);
+	    }
+	  else
+	    stream->wrap_here (2 + 2 * recurse);
+	}
+
+      if (is_map && i % 2 == 0)
+	gdb_puts ("[", stream);
+      else if (is_array)
+	{
+	  /* We print the index, not whatever the child's name is.  */
+	  if (options->print_array_indexes)
+	    gdb_printf (stream, "[%d] = ", i);
+	}
+      else if (!is_map)
+	{
+	  gdb_puts (children.name (), stream);
+	  gdb_puts (" = ", stream);
+	}
+
+      /* When printing the key of a map we allow one additional level of
+	 depth.  This means the key will print before the value does.  */
+      struct value_print_options opts = *options;
+      if (is_map && i % 2 == 0
+	  && opts.max_depth != -1
+	  && opts.max_depth < INT_MAX)
+	++opts.max_depth;
+      children.print (stream, recurse + 1, &opts, language);
+
+      if (is_map && i % 2 == 0)
+	gdb_puts ("] = ", stream);
+    }
+
+  if (i)
+    {
+      if (!done)
+	{
+	  if (pretty)
+	    {
+	      gdb_puts ("\n", stream);
+	      print_spaces (2 + 2 * recurse, stream);
+	    }
+	  gdb_puts ("...", stream);
+	}
+      if (pretty)
+	{
+	  gdb_puts ("\n", stream);
+	  print_spaces (2 * recurse, stream);
+	}
+      gdb_puts ("}", stream);
+    }
+}
+
 /* Check whether the value VAL is printable.  Return 1 if it is;
    return 0 and print an appropriate error message to STREAM according to
    OPTIONS if it is not.  */
@@ -329,6 +329,75 @@ extern bool val_print_check_max_depth (struct ui_file *stream, int recurse,
 				       const struct value_print_options *opts,
 				       const struct language_defn *language);
 
+/* How the children of a value printed by a pretty-printer are laid
+   out, following the printer's display hint.  */
+
+enum class pretty_children_layout
+{
+  /* Each child is printed as "NAME = VALUE".  */
+  STRUCT,
+
+  /* The display hint is "array": only the values of the children are
+     printed, with their index if "set print array-indexes" is on.  */
+  ARRAY,
+
+  /* The display hint is "map": the children alternate between keys
+     and values, and are printed as "[KEY] = VALUE".  */
+  MAP,
+};
+
+/* The result of fetching a child for print_pretty_children.  */
+
+enum class pretty_child_status
+{
+  /* The child was fetched, and is printed.  */
+  CHILD,
+
+  /* There are no more children.  */
+  END,
+
+  /* The children could not be fetched any further.  Any error has been
+     reported already.  */
+  STOP,
+
+  /* This child could not be fetched, and is skipped.  The error has
+     been reported already.  */
+  SKIP,
+};
+
+/* The children of a value printed by a pretty-printer, as provided to
+   print_pretty_children.  */
+
+struct pretty_children
+{
+  virtual ~pretty_children () = default;
+
+  /* Fetch the next child, which is child number N.  */
+  virtual pretty_child_status fetch (unsigned int n) = 0;
+
+  /* Return the name of the child fetched last.  */
+  virtual const char *name () = 0;
+
+  /* Print the value of the child fetched last.  STREAM, RECURSE,
+     OPTIONS and LANGUAGE are as for common_val_print.  */
+  virtual void print (struct ui_file *stream, int recurse,
+		      const struct value_print_options *options,
+		      const struct language_defn *language) = 0;
+};
+
+/* Print CHILDREN, the children of a value printed by a pretty-printer,
+   to STREAM as "{CHILD, CHILD...}", following LAYOUT.  This comes after
+   the printer's summary of the value, which is separated from the
+   children by " = " if PRINT_EQUALS.  RECURSE, OPTIONS and LANGUAGE are
+   those the value is printed with.  */
+
+extern void print_pretty_children (pretty_children &children,
+				   pretty_children_layout layout,
+				   bool print_equals,
+				   struct ui_file *stream, int recurse,
+				   const struct value_print_options *options,
+				   const struct language_defn *language);
+
 /* Like common_val_print, but call value_check_printable first.  */
 
 extern void common_val_print_checked
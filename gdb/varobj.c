@@ -30,6 +30,9 @@
 #include "varobj-iter.h"
 #include "parser-defs.h"
 #include "gdbarch.h"
+#include "target.h"
+#include "gdbsupport/byte-vector.h"
+#include "gdbsupport/unordered_map.h"
 #include <algorithm>
 #include "observable.h"
 
@@ -1430,11 +1433,268 @@ varobj_value_has_mutated (const struct varobj *var, struct value *new_value,
     return false;
 }
 
+/* Target memory read in bulk by varobj_update, before walking the
+   varobjs, to find the subtrees whose memory did not change.  Those
+   are then skipped entirely: their values are neither read one by
+   one, nor printed, nor looked up for a pretty-printer.  */
+
+class varobj_memory_snapshot
+{
+public:
+  /* Note that VAR is unchanged if its new value lives where its old
+     one did, and the contents of the old values of LEAVES are still
+     in memory.  */
+  void add_candidate (const struct varobj *var,
+		      std::vector<const struct varobj *> &&leaves)
+  {
+    for (const varobj *leaf : leaves)
+      {
+	struct value *val = leaf->value.get ();
+	if (val->type ()->length () > 0)
+	  m_ranges.emplace_back (val->address (), val->type ()->length ());
+      }
+    m_candidates.emplace (var, std::move (leaves));
+  }
+
+  /* Read the memory of all the candidates, merging ranges that are
+     close to each other.  */
+  void fetch ();
+
+  /* Return true if VAR, whose new value is NEW_VALUE, and all of its
+     children are unchanged.  */
+  bool subtree_unchanged_p (const struct varobj *var,
+			    struct value *new_value) const;
+
+private:
+  /* Return true if the memory at ADDR was read, and holds
+     CONTENTS.  */
+  bool memory_unchanged_p (CORE_ADDR addr,
+			   gdb::array_view<const gdb_byte> contents) const;
+
+  /* Ranges can be merged across holes up to this size.  */
+  static constexpr ULONGEST merge_gap = 64;
+
+  /* Merged blocks are not grown past this size.  */
+  static constexpr ULONGEST max_block_size = 64 * 1024;
+
+  /* The candidates, and the varobjs whose contents need comparing.  */
+  gdb::unordered_map<const varobj *,
+		     std::vector<const varobj *>> m_candidates;
+
+  /* The (address, length) ranges to read.  */
+  std::vector<std::pair<CORE_ADDR, ULONGEST>> m_ranges;
+
+  /* The blocks of memory read, sorted by address.  */
+  std::vector<std::pair<CORE_ADDR, gdb::byte_vector>> m_blocks;
+};
+
+void
+varobj_memory_snapshot::fetch ()
+{
+  std::sort (m_ranges.begin (), m_ranges.end ());
+
+  for (size_t i = 0; i < m_ranges.size (); )
+    {
+      CORE_ADDR start = m_ranges[i].first;
+      CORE_ADDR end = start + m_ranges[i].second;
+
+      for (++i; i < m_ranges.size (); ++i)
+	{
+	  CORE_ADDR next_end = m_ranges[i].first + m_ranges[i].second;
+
+	  if (m_ranges[i].first > end + merge_gap
+	      || (m_ranges[i].first > end
+		  && next_end - start > max_block_size))
+	    break;
+	  end = std::max (end, next_end);
+	}
+
+      gdb::byte_vector buf (end - start);
+      if (target_read_memory (start, buf.data (), buf.size ()) == 0)
+	m_blocks.emplace_back (start, std::move (buf));
+    }
+}
+
+bool
+varobj_memory_snapshot::memory_unchanged_p
+  (CORE_ADDR addr, gdb::array_view<const gdb_byte> contents) const
+{
+  if (contents.empty ())
+    return true;
+
+  auto it = std::upper_bound (m_blocks.begin (), m_blocks.end (), addr,
+			      [] (CORE_ADDR a, const auto &block)
+			      {
+				return a < block.first;
+			      });
+  if (it == m_blocks.begin ())
+    return false;
+  --it;
+
+  const gdb::byte_vector &bytes = it->second;
+  CORE_ADDR offset = addr - it->first;
+  if (offset + contents.size () > bytes.size ())
+    return false;
+
+  return memcmp (bytes.data () + offset, contents.data (),
+		 contents.size ()) == 0;
+}
+
+bool
+varobj_memory_snapshot::subtree_unchanged_p (const struct varobj *var,
+					     struct value *new_value) const
+{
+  auto it = m_candidates.find (var);
+  if (it == m_candidates.end () || new_value == nullptr)
+    return false;
+
+  struct value *old_value = var->value.get ();
+  new_value = coerce_ref (new_value);
+  if (new_value->lval () != lval_memory
+      || new_value->type () != old_value->type ()
+      || new_value->address () != old_value->address ()
+      || new_value->bitsize () != 0
+      || new_value->embedded_offset () != 0)
+    return false;
+
+  for (const varobj *leaf : it->second)
+    if (!memory_unchanged_p (leaf->value->address (),
+			     leaf->value->contents ()))
+      return false;
+
+  return true;
+}
+
+/* Return true if the current value of VAR lives in target memory,
+   and how VAR is printed depends only on the bytes there, so that VAR
+   is unchanged for as long as they are.  */
+
+static bool
+varobj_memory_comparable_p (const struct varobj *var)
+{
+  if (var->type == nullptr || var->value == nullptr
+      || var->dynamic->pretty_printer != nullptr
+      || var->updated || var->not_fetched
+      || (var->parent != nullptr && varobj_is_dynamic_p (var->parent)))
+    return false;
+
+  struct value *val = var->value.get ();
+  if (val->lval () != lval_memory
+      || val->bitsize () != 0
+      || val->embedded_offset () != 0)
+    return false;
+
+  if (val->lazy ())
+    {
+      /* Only the values which are never compared are left lazy.  */
+      if (varobj_value_is_changeable_p (var))
+	return false;
+    }
+  else if (val->optimized_out () || !val->entirely_available ())
+    return false;
+
+  /* The printed form of pointers may include what they point to.  */
+  switch (check_typedef (val->type ())->code ())
+    {
+    case TYPE_CODE_PTR:
+    case TYPE_CODE_REF:
+    case TYPE_CODE_RVALUE_REF:
+    case TYPE_CODE_FUNC:
+    case TYPE_CODE_METHOD:
+      return false;
+    default:
+      return true;
+    }
+}
+
+/* Return true if all the children of VAR which varobj_update would
+   walk are comparable with memory, and lie in [LO, HI).  Add those
+   whose values were fetched to LEAVES.  */
+
+static bool
+varobj_children_comparable_p (const struct varobj *var,
+			      CORE_ADDR lo, CORE_ADDR hi,
+			      std::vector<const struct varobj *> &leaves)
+{
+  for (const varobj *child : var->children)
+    {
+      if (child == nullptr || child->frozen)
+	continue;
+
+      if (!CPLUS_FAKE_CHILD (child))
+	{
+	  if (!varobj_memory_comparable_p (child))
+	    return false;
+
+	  struct value *val = child->value.get ();
+	  CORE_ADDR addr = val->address ();
+	  if (addr < lo || addr + val->type ()->length () > hi)
+	    return false;
+
+	  if (!val->lazy ())
+	    leaves.push_back (child);
+	}
+
+      if (!varobj_children_comparable_p (child, lo, hi, leaves))
+	return false;
+    }
+
+  return true;
+}
+
+/* Find the largest subtrees of the tree rooted at VAR whose changes
+   can be found by comparing memory, and add them to SNAPSHOT.  */
+
+static void
+varobj_collect_snapshot_candidates (const struct varobj *var,
+				    varobj_memory_snapshot &snapshot)
+{
+  if (!CPLUS_FAKE_CHILD (var) && varobj_memory_comparable_p (var))
+    {
+      struct value *val = var->value.get ();
+      CORE_ADDR lo = val->address ();
+      CORE_ADDR hi = lo + val->type ()->length ();
+      std::vector<const varobj *> leaves;
+
+      if (!val->lazy ())
+	leaves.push_back (var);
+
+      if (varobj_children_comparable_p (var, lo, hi, leaves))
+	{
+	  snapshot.add_candidate (var, std::move (leaves));
+	  return;
+	}
+    }
+
+  for (const varobj *child : var->children)
+    if (child != nullptr && !child->frozen)
+      varobj_collect_snapshot_candidates (child, snapshot);
+}
+
+/* Switch to the thread whose context ROOT is evaluated in, as
+   value_of_root_1 does.  Return false if that thread is gone.  */
+
+static bool
+switch_to_root_thread (const struct varobj_root *root)
+{
+  if (root->valid_block == nullptr || root->floating
+      || root->thread_id == 0)
+    return true;
+
+  thread_info *thread = find_thread_global_id (root->thread_id);
+  if (thread == nullptr)
+    return false;
+
+  switch_to_thread (thread);
+  return true;
+}
+
 /* Update the values for a variable and its children.  This is a
    two-pronged attack.  First, re-parse the value for the root's
    expression to see if it's changed.  Then go all the way
    through its children, reconstructing them and noting if they've
-   changed.
+   changed.  The memory backing the varobjs is read in bulk first,
+   and the subtrees whose memory did not change are skipped.
 
    The IS_EXPLICIT parameter specifies if this call is result
    of MI request to update this specific variable, or
@@ -1467,6 +1727,18 @@ varobj_update (struct varobj **varp, bool is_explicit)
       return result;
     }
 
+  /* Read the memory backing the varobjs in bulk, to skip the
+     subtrees whose memory did not change.  This is done in the context
+     the root is evaluated in, see value_of_root_1.  If the root's
+     thread is gone, nothing is read, and no subtree is skipped.  */
+  varobj_memory_snapshot snapshot;
+  varobj_collect_snapshot_candidates (*varp, snapshot);
+  {
+    scoped_restore_current_thread restore_thread;
+    if (switch_to_root_thread ((*varp)->root))
+      snapshot.fetch ();
+  }
+
   if ((*varp)->root->rootvar == *varp)
     {
       varobj_update_result r (*varp);
@@ -1479,6 +1751,9 @@ varobj_update (struct varobj **varp, bool is_explicit)
       newobj = value_of_root (varp, &type_changed);
       if (update_type_if_necessary (*varp, newobj))
 	  type_changed = true;
+      if (!type_changed && snapshot.subtree_unchanged_p (*varp, newobj))
+	return result;
+
       r.varobj = *varp;
       r.type_changed = type_changed;
       if (install_new_value ((*varp), newobj, type_changed))
@@ -1517,6 +1792,8 @@ varobj_update (struct varobj **varp, bool is_explicit)
 	  newobj = value_of_child (v->parent, v->index);
 	  if (update_type_if_necessary (v, newobj))
 	    r.type_changed = true;
+	  if (!r.type_changed && snapshot.subtree_unchanged_p (v, newobj))
+	    continue;
 	  if (newobj)
 	    new_type = newobj->type ();
 	  else
@@ -58,6 +58,7 @@
 #include <fcntl.h>
 #endif
 #include "gdbsupport/gdb_sys_time.h"
+#include <chrono>
 #include <unistd.h>
 #if HAVE_ARPA_INET_H
 #include <arpa/inet.h>
@@ -101,6 +102,16 @@ static int remote_is_stdio = 0;
 static int remote_desc = -1;
 static int listen_desc = -1;
 
+/* See remote-utils.h.  */
+
+int reply_delay_ms = 0;
+
+/* When readchar_buf was last filled, and when the packet being
+   handled arrived.  Only tracked when REPLY_DELAY_MS is set.  */
+
+static std::chrono::steady_clock::time_point readchar_fill_time;
+static std::chrono::steady_clock::time_point packet_arrival_time;
+
 #ifdef USE_WIN32API
 /* gnulib wraps these as macros, undo them.  */
 # undef read
@@ -690,6 +701,20 @@ putpkt_binary_1 (char *buf, int cnt, int is_notif)
 
   *p = '\0';
 
+  /* Hold the reply back as if it had taken REPLY_DELAY_MS to reach us
+     from GDB.  Requests that arrived together are answered together,
+     as on a link with that latency.  */
+  if (reply_delay_ms > 0 && !is_notif)
+    {
+      using namespace std::chrono;
+
+      steady_clock::time_point due
+	= packet_arrival_time + milliseconds (reply_delay_ms);
+      steady_clock::time_point now = steady_clock::now ();
+      if (due > now)
+	usleep (duration_cast<microseconds> (due - now).count ());
+    }
+
   /* Send it over and over until we get a positive ack.  */
 
   do
@@ -900,6 +925,8 @@ readchar (void)
 	}
 
       readchar_bufp = readchar_buf;
+      if (reply_delay_ms > 0)
+	readchar_fill_time = std::chrono::steady_clock::now ();
     }
 
   readchar_bufcnt--;
@@ -982,6 +1009,24 @@ getpkt (char *buf)
       bp = buf;
       while (1)
 	{
+	  /* Copy the packet data that is already buffered in one go,
+	     rather than a character at a time.  */
+	  if (readchar_bufcnt > 0)
+	    {
+	      unsigned char *hash
+		= (unsigned char *) memchr (readchar_bufp, '#',
+					    readchar_bufcnt);
+	      int len = (hash != nullptr
+			 ? hash - readchar_bufp : readchar_bufcnt);
+
+	      memcpy (bp, readchar_bufp, len);
+	      for (int i = 0; i < len; i++)
+		csum += readchar_bufp[i];
+	      bp += len;
+	      readchar_bufp += len;
+	      readchar_bufcnt -= len;
+	    }
+
 	  c = readchar ();
 	  if (c < 0)
 	    return -1;
@@ -1026,6 +1071,8 @@ getpkt (char *buf)
   else
     remote_debug_printf ("getpkt (\"%s\");  [no ack sent]", buf);
 
+  packet_arrival_time = readchar_fill_time;
+
   /* The readchar above may have already read a '\003' out of the socket
      and moved it to the local buffer.  For example, when GDB sends
      vCont;c immediately followed by interrupt (see
@@ -27,6 +27,11 @@ int remote_connection_is_stdio (void);
 ptid_t read_ptid (const char *buf, const char **obuf);
 char *write_ptid (char *buf, ptid_t ptid);
 
+/* The number of milliseconds gdbserver waits, after receiving a
+   request, before sending the reply.  Used to test how GDB copes with
+   high-latency links.  See "monitor set reply-delay".  */
+extern int reply_delay_ms;
+
 int putpkt (char *buf);
 int putpkt_binary (char *buf, int len);
 int putpkt_notif (char *buf);
@@ -50,8 +50,10 @@
 #include "gdbsupport/scoped_restore.h"
 #include "gdbsupport/search.h"
 #include "gdbsupport/remote-args.h"
+#include "gdbsupport/byte-vector.h"
 
 #include <getopt.h>
+#include <zlib.h>
 
 /* PBUFSIZ must also be at least as big as IPA_CMD_BUF_SIZE, because
    the client state data is passed directly to some agent
@@ -146,6 +148,7 @@ bool disable_packet_Tthread;
 bool disable_packet_qC;
 bool disable_packet_qfThreadInfo;
 bool disable_packet_T;
+bool disable_packet_pipelined_reads;
 
 static unsigned char *mem_buf;
 
@@ -398,6 +401,65 @@ write_qxfer_response (char *buf, const gdb_byte *data, int len, int is_more)
 			       &out_len, PBUFSIZ - 2) + 1;
 }
 
+/* Replies shorter than this are not worth compressing.  */
+#define COMPRESS_REPLY_MIN_SIZE 64
+
+/* Return true if the reply to the request in BUF carries bulk binary
+   data, and may thus be sent compressed if GDB supports it.  */
+
+static bool
+compressible_request_p (const char *buf)
+{
+  return (buf[0] == 'm'
+	  || buf[0] == 'x'
+	  || (startswith (buf, "qXfer:") && strstr (buf, ":read:") != NULL)
+	  || startswith (buf, "vFile:pread:"));
+}
+
+/* Try to replace the PACKET_LEN bytes long reply in OWN_BUF with its
+   compressed form, "Z<length>;<data>", where LENGTH is PACKET_LEN in
+   hex, and DATA is the binary escaped zlib stream holding the original
+   reply.  Return the length of the reply to send, which is still
+   PACKET_LEN if compressing would not make the reply shorter.  */
+
+static int
+compress_reply (char *own_buf, int packet_len)
+{
+  if (packet_len < COMPRESS_REPLY_MIN_SIZE)
+    return packet_len;
+
+  /* The target may well be a slow embedded system; favor speed over
+     compression ratio.  */
+  uLongf zlen = compressBound (packet_len);
+  gdb::byte_vector zdata (zlen);
+  if (compress2 (zdata.data (), &zlen, (const Bytef *) own_buf, packet_len,
+		 Z_BEST_SPEED) != Z_OK)
+    return packet_len;
+
+  char header[20];
+  int header_len = xsnprintf (header, sizeof (header), "Z%x;", packet_len);
+
+  /* Escaping never makes the data shorter.  */
+  if (header_len + zlen >= packet_len)
+    return packet_len;
+
+  gdb::byte_vector reply (packet_len);
+  int out_len_units;
+  memcpy (reply.data (), header, header_len);
+  int escaped_len = remote_escape_output (zdata.data (), zlen, 1,
+					  reply.data () + header_len,
+					  &out_len_units,
+					  packet_len - 1 - header_len);
+  if (out_len_units != zlen)
+    return packet_len;
+
+  remote_debug_printf ("compressed reply: %d -> %d bytes",
+		       packet_len, header_len + escaped_len);
+
+  memcpy (own_buf, reply.data (), header_len + escaped_len);
+  return header_len + escaped_len;
+}
+
 /* Handle btrace enabling in BTS format.  */
 
 static void
@@ -1171,6 +1233,8 @@ monitor_show_help (void)
   monitor_output ("  set debug-format option1[,option2,...]\n");
   monitor_output ("    Add additional information to debugging messages\n");
   monitor_output ("    Options: all, none, timestamp\n");
+  monitor_output ("  set reply-delay MILLISECONDS\n");
+  monitor_output ("    Delay each reply, as on a link with that latency\n");
   monitor_output ("  exit\n");
   monitor_output ("    Quit GDBserver\n");
 }
@@ -1754,6 +1818,24 @@ handle_monitor_command (const char *mon, char *own_buf)
     debug_set_output (nullptr);
   else if (startswith (mon, "set debug-file "))
     debug_set_output (mon + sizeof ("set debug-file ") - 1);
+  else if (startswith (mon, "set reply-delay "))
+    {
+      const char *arg = mon + sizeof ("set reply-delay ") - 1;
+      char *end;
+      long ms = strtol (arg, &end, 10);
+
+      if (*arg == '\0' || *end != '\0' || ms < 0 || ms > INT_MAX)
+	{
+	  monitor_output ("Invalid reply delay.\n");
+	  write_enn (own_buf);
+	}
+      else
+	{
+	  reply_delay_ms = ms;
+	  monitor_output (string_printf ("Replies delayed by %d ms.\n",
+					 reply_delay_ms).c_str ());
+	}
+    }
   else if (strcmp (mon, "help") == 0)
     monitor_show_help ();
   else if (strcmp (mon, "exit") == 0)
@@ -2747,6 +2829,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 		cs.single_inferior_argument = true;
 	      else if (feature == "multi-wp-addr+")
 		cs.multiple_wp_addr_feature = true;
+	      else if (feature == "zlib-compression+")
+		cs.zlib_compression = true;
 	      else
 		{
 		  /* Move the unknown features all together.  */
@@ -2797,6 +2881,15 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       if (cs.transport_is_reliable)
 	strcat (own_buf, ";QStartNoAckMode+");
 
+      /* Incoming packets are buffered and handled one at a time, so
+	 GDB may send several memory or file reads before reading the
+	 replies.  GDB only does that without acks, which needs a
+	 reliable transport.  */
+      if (cs.transport_is_reliable && !disable_packet_pipelined_reads)
+	strcat (own_buf, ";pipelined-reads+");
+
+      strcat (own_buf, ";zlib-compression+");
+
       if (the_target->supports_qxfer_osdata ())
 	strcat (own_buf, ";qXfer:osdata:read+");
 
@@ -3931,7 +4024,8 @@ gdbserver_usage (FILE *stream)
 	   "  --disable-packet=OPT1[,OPT2,...]\n"
 	   "                        Disable support for RSP packets or features.\n"
 	   "                          Options:\n"
-	   "                            vCont, vConts, T, Tthread, qC, qfThreadInfo and\n"
+	   "                            vCont, vConts, T, Tthread, qC, qfThreadInfo,\n"
+	   "                            pipelined-reads and\n"
 	   "                            threads (disable all threading packets).\n"
 	   "\n"
 	   "For more information, consult the GDB manual (available as on-line \n"
@@ -3950,7 +4044,8 @@ gdbserver_show_disableable (FILE *stream)
 	   "  Tthread     \tPassing the thread specifier in the "
 	   "T stop reply packet\n"
 	   "  threads     \tAll of the above\n"
-	   "  T           \tAll 'T' packets\n");
+	   "  T           \tAll 'T' packets\n"
+	   "  pipelined-reads\tSeveral memory or file reads in flight at once\n");
 }
 
 /* Start up the event loop.  This is the entry point to the event
@@ -4396,6 +4491,8 @@ captured_main (int argc, char *argv[])
 		  disable_packet_qfThreadInfo = true;
 		else if (strcmp ("T", tok) == 0)
 		  disable_packet_T = true;
+		else if (strcmp ("pipelined-reads", tok) == 0)
+		  disable_packet_pipelined_reads = true;
 		else if (strcmp ("threads", tok) == 0)
 		  {
 		    disable_packet_vCont = true;
@@ -4635,6 +4732,7 @@ captured_main (int argc, char *argv[])
       cs.memory_tagging_feature = false;
       cs.error_message_supported = false;
       cs.multiple_wp_addr_feature = false;
+      cs.zlib_compression = false;
 
       remote_open (port);
 
@@ -4823,6 +4921,11 @@ process_serial_event (void)
     }
   response_needed = true;
 
+  /* Whether the reply to this request may be sent compressed.  Check
+     now, as the request is overwritten by the reply.  */
+  bool compress = (cs.zlib_compression
+		   && compressible_request_p (cs.own_buf));
+
   char ch = cs.own_buf[0];
   switch (ch)
     {
@@ -4954,7 +5057,12 @@ process_serial_event (void)
 	if (res < 0)
 	  write_enn (cs.own_buf);
 	else
-	  bin2hex (mem_buf, cs.own_buf, res);
+	  {
+	    bin2hex (mem_buf, cs.own_buf, res);
+	    /* Send the reply through putpkt_binary, so that it can be
+	       compressed.  */
+	    new_packet_len = strlen (cs.own_buf);
+	  }
       }
       break;
     case 'M':
@@ -5172,7 +5280,11 @@ process_serial_event (void)
     }
 
   if (new_packet_len != -1)
-    putpkt_binary (cs.own_buf, new_packet_len);
+    {
+      if (compress)
+	new_packet_len = compress_reply (cs.own_buf, new_packet_len);
+      putpkt_binary (cs.own_buf, new_packet_len);
+    }
   else
     putpkt (cs.own_buf);
 
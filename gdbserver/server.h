@@ -73,6 +73,7 @@ extern bool disable_packet_Tthread;
 extern bool disable_packet_qC;
 extern bool disable_packet_qfThreadInfo;
 extern bool disable_packet_T;
+extern bool disable_packet_pipelined_reads;
 
 extern bool run_once;
 extern bool non_stop;
@@ -207,6 +208,10 @@ struct client_state
      a 'T' stop reply packet.  When false, GDB only expects (at most) a
      single watchpoint address, and gdbserver must select one.  */
   bool multiple_wp_addr_feature = false;
+
+  /* If true, GDB accepts zlib-compressed replies to bulk data
+     transfer requests.  */
+  bool zlib_compression = false;
 };
 
 client_state &get_client_state ();
@@ -19,6 +19,7 @@
 #include "tracepoint.h"
 #include "gdbthread.h"
 #include "gdbsupport/rsp-low.h"
+#include "gdbsupport/byte-vector.h"
 
 #include <fcntl.h>
 #include <unistd.h>
@@ -5858,6 +5859,69 @@ download_trace_state_variables (void)
     }
 }
 
+/* A local copy of the live part of the IP Agent's trace buffer.
+   Uploading traceframes used to cost two inferior memory reads per
+   traceframe (header, then data); with a snapshot, the whole batch is
+   brought over with at most two bulk reads, one per side of the
+   wraparound point, and the traceframes are then parsed locally.  */
+
+struct ipa_trace_buffer_snapshot
+{
+  /* Copy the regions of the IPA trace buffer that may hold
+     traceframes, as described by CTRL.  LO is the start of the IPA
+     trace buffer.  Regions that can't be read are left out; reads
+     of those fall back to reading inferior memory directly.  */
+  void fetch (CORE_ADDR lo, const ipa_trace_buffer_control &ctrl)
+  {
+    if (ctrl.start < ctrl.free)
+      fetch_window (0, ctrl.start, ctrl.free);
+    else
+      {
+	/* The buffer wrapped around.  */
+	fetch_window (0, ctrl.start, ctrl.wrap);
+	fetch_window (1, lo, ctrl.free);
+      }
+  }
+
+  /* Read LEN bytes at ADDR of the IPA trace buffer into BUF.  Returns
+     0 on success, like read_inferior_memory.  */
+  int read (CORE_ADDR addr, unsigned char *buf, ULONGEST len) const
+  {
+    for (const window &w : m_windows)
+      if (addr >= w.addr && addr + len <= w.addr + w.bytes.size ())
+	{
+	  memcpy (buf, w.bytes.data () + (addr - w.addr), len);
+	  return 0;
+	}
+
+    return read_inferior_memory (addr, buf, len);
+  }
+
+private:
+  struct window
+  {
+    CORE_ADDR addr = 0;
+    gdb::byte_vector bytes;
+  };
+
+  void fetch_window (int idx, CORE_ADDR from, CORE_ADDR to)
+  {
+    window &w = m_windows[idx];
+
+    w.addr = from;
+    w.bytes.resize (to > from ? to - from : 0);
+    if (!w.bytes.empty ()
+	&& read_inferior_memory (from, w.bytes.data (), w.bytes.size ()) != 0)
+      {
+	trace_debug ("Lib: couldn't snapshot trace buffer at %s",
+		     paddress (from));
+	w.bytes.clear ();
+      }
+  }
+
+  window m_windows[2];
+};
+
 /* Upload complete trace frames out of the IP Agent's trace buffer
    into GDBserver's trace buffer.  This always uploads either all or
    no trace frames.  This is the counter part of
@@ -6005,6 +6069,9 @@ upload_fast_traceframes (void)
       ? (ipa_trace_buffer_ctrl.wrap - ipa_trace_buffer_lo)		\
       : 0))
 
+  ipa_trace_buffer_snapshot snapshot;
+  snapshot.fetch (ipa_trace_buffer_lo, ipa_trace_buffer_ctrl);
+
   tf = IPA_FIRST_TRACEFRAME ();
 
   while (ipa_traceframe_write_count - ipa_traceframe_read_count)
@@ -6014,8 +6081,8 @@ upload_fast_traceframes (void)
       unsigned char *block;
       struct traceframe ipa_tframe;
 
-      if (read_inferior_memory (tf, (unsigned char *) &ipa_tframe,
-				offsetof (struct traceframe, data)))
+      if (snapshot.read (tf, (unsigned char *) &ipa_tframe,
+			 offsetof (struct traceframe, data)))
 	error ("Uploading: couldn't read traceframe at %s\n", paddress (tf));
 
       if (ipa_tframe.tpnum == 0)
@@ -6044,9 +6111,8 @@ upload_fast_traceframes (void)
 					ipa_tframe.data_size);
 	  if (block != NULL)
 	    {
-	      if (read_inferior_memory (tf
-					+ offsetof (struct traceframe, data),
-					block, ipa_tframe.data_size))
+	      if (snapshot.read (tf + offsetof (struct traceframe, data),
+				 block, ipa_tframe.data_size))
 		error ("Uploading: Couldn't read traceframe data at %s\n",
 		       paddress (tf + offsetof (struct traceframe, data)));
 	    }